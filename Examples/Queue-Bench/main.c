@@ -0,0 +1,525 @@
+/**
+ * @file main.c
+ * @author Ali Mirghasemi (ali.mirghasemi1376@gmail.com)
+ * @brief throughput and latency benchmark of Queue APIs
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Output is CSV, one line per run, lines that start with '#' are comments
+ * and show compile time configuration (STREAM_MUTEX, STREAM_*_LIMIT, ...),
+ * build library with each configuration and keep output for track regressions.
+ * Latency of single thread runs is time of one round (write batch items then read them),
+ * latency of thread runs is end-to-end time of an item from producer to consumer.
+ *
+ * Usage: Queue-Bench [-q]
+ *  -q  quick run, 16x less items
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Queue.h"
+#include "QueueMPMC.h"
+
+#define BENCH_ITEMS                     (1UL << 20)
+#define BENCH_THREAD_ITEMS              (1UL << 18)
+#define BENCH_MAX_SAMPLES               (1UL << 16)
+#define BENCH_SAMPLE_MASK               63
+#define BENCH_BATCH                     32
+#define BENCH_MAX_ITEM_SIZE             256
+#define BENCH_MAX_THREADS               4
+
+static const Queue_LenType ITEM_SIZES[] = { 8, 16, 64, 256 };
+static const Queue_LenType BUFFER_ITEMS[] = { 64, 1024, 16384 };
+static const int THREAD_PAIRS[] = { 1, 2, 4 };
+
+#define ARRAY_LEN(ARR)                  (sizeof(ARR) / sizeof(ARR[0]))
+
+typedef struct {
+    uint64_t*       Values;
+    uint32_t        Len;
+    uint32_t        Cap;
+} Samples;
+
+typedef struct {
+    const char*     Bench;
+    const char*     Api;
+    Queue_LenType   ItemSize;
+    Queue_LenType   BufferItems;
+    Queue_LenType   Batch;
+    int             Producers;
+    int             Consumers;
+    int             Limit;
+    uint64_t        Items;
+    uint64_t        Time;
+} Result;
+
+static unsigned long benchItems = BENCH_ITEMS;
+static unsigned long benchThreadItems = BENCH_THREAD_ITEMS;
+
+static uint64_t nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static void Samples_add(Samples* samples, uint64_t value) {
+    if (samples->Len < samples->Cap) {
+        samples->Values[samples->Len++] = value;
+    }
+}
+
+static int compareU64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+    return x < y ? -1 : x > y;
+}
+
+static uint64_t Samples_percentile(Samples* samples, uint32_t permille) {
+    if (samples->Len == 0) {
+        return 0;
+    }
+    return samples->Values[(uint64_t) (samples->Len - 1) * permille / 1000];
+}
+
+static void printConfig(void) {
+    printf("# Queue-Bench version=%s\n", QUEUE_VER_STR);
+    printf("# config STREAM_MUTEX=%d STREAM_WRITE_LIMIT=%d STREAM_READ_LIMIT=%d STREAM_WRITE_ARRAY=%d STREAM_READ_ARRAY=%d STREAM_WRITE_STREAM=%d\n",
+           (int) STREAM_MUTEX, (int) STREAM_WRITE_LIMIT, (int) STREAM_READ_LIMIT,
+           (int) STREAM_WRITE_ARRAY, (int) STREAM_READ_ARRAY, (int) STREAM_WRITE_STREAM);
+    printf("# config QUEUE_SPSC=%d QUEUE_MPMC=%d QUEUE_WAIT=%d QUEUE_MIRROR=%d\n",
+           (int) QUEUE_SPSC, (int) QUEUE_MPMC, (int) QUEUE_WAIT, (int) QUEUE_MIRROR);
+    printf("bench,api,item_size,buffer_items,batch,producers,consumers,limit,items,seconds,items_per_s,gb_per_s,p50_ns,p99_ns,p999_ns\n");
+}
+
+static void report(const Result* result, Samples* samples) {
+    double seconds = (double) result->Time / 1e9;
+    double itemsPerSec = seconds > 0 ? (double) result->Items / seconds : 0;
+
+    qsort(samples->Values, samples->Len, sizeof(uint64_t), compareU64);
+    printf("%s,%s,%d,%d,%d,%d,%d,%d,%llu,%.6f,%.0f,%.4f,%llu,%llu,%llu\n",
+           result->Bench, result->Api,
+           (int) result->ItemSize, (int) result->BufferItems, (int) result->Batch,
+           result->Producers, result->Consumers, result->Limit,
+           (unsigned long long) result->Items, seconds, itemsPerSec,
+           itemsPerSec * (double) result->ItemSize / 1e9,
+           (unsigned long long) Samples_percentile(samples, 500),
+           (unsigned long long) Samples_percentile(samples, 990),
+           (unsigned long long) Samples_percentile(samples, 999));
+    fflush(stdout);
+}
+
+static void setLimits(Queue* queue, int limit) {
+#if STREAM_WRITE_LIMIT
+    Queue_setWriteLimit(queue, limit ? Queue_getBufferSize(queue) : QUEUE_NO_LIMIT);
+#endif
+#if STREAM_READ_LIMIT
+    Queue_setReadLimit(queue, limit ? Queue_getBufferSize(queue) : QUEUE_NO_LIMIT);
+#endif
+    (void) queue;
+    (void) limit;
+}
+
+static void refreshLimits(Queue* queue, int limit) {
+    if (limit) {
+        setLimits(queue, limit);
+    }
+}
+
+// -------------------------- Query callbacks ----------------------------
+static uint8_t queryItem[BENCH_MAX_ITEM_SIZE * BENCH_BATCH];
+
+static Queue_Result writeQueryFn(Queue* queue, void* val, Queue_LenType index, Queue_LenType len) {
+    (void) len;
+    memcpy(val, &queryItem[index * queue->ItemSize], queue->ItemSize);
+    return Queue_Ok;
+}
+
+static Queue_Result readQueryFn(Queue* queue, void* val, Queue_LenType index, Queue_LenType len) {
+    (void) len;
+    memcpy(&queryItem[index * queue->ItemSize], val, queue->ItemSize);
+    return Queue_Ok;
+}
+
+static Queue_Result writeBatchFn(Queue* queue, void* val, Queue_LenType index, Queue_LenType count, Queue_LenType len) {
+    (void) len;
+    memcpy(val, &queryItem[index * queue->ItemSize], count * queue->ItemSize);
+    return Queue_Ok;
+}
+
+static Queue_Result readBatchFn(Queue* queue, void* val, Queue_LenType index, Queue_LenType count, Queue_LenType len) {
+    (void) len;
+    memcpy(&queryItem[index * queue->ItemSize], val, count * queue->ItemSize);
+    return Queue_Ok;
+}
+
+// -------------------------- Single thread ----------------------------
+typedef enum {
+    Api_WriteRead,
+    Api_WriteReadArray,
+    Api_QueryArray,
+    Api_QueryBatch,
+    Api_WriteQueue,
+    Api_Count,
+} Api;
+
+static const char* API_NAMES[Api_Count] = {
+    "write/read",
+    "writeArray/readArray",
+    "writeQueryArray/readQueryArray",
+    "writeQueryBatch/readQueryBatch",
+    "writeQueue",
+};
+
+/**
+ * @brief run one round of api, write batch items then read them back
+ * @return number of items moved, 0 if api not supported
+ */
+static Queue_LenType runRound(Api api, Queue* queue, Queue* other, uint8_t* items, Queue_LenType batch) {
+    Queue_LenType i;
+
+    switch (api) {
+        case Api_WriteRead:
+            for (i = 0; i < batch; i++) {
+                Queue_write(queue, &items[i * queue->ItemSize]);
+            }
+            for (i = 0; i < batch; i++) {
+                Queue_read(queue, &items[i * queue->ItemSize]);
+            }
+            return batch;
+        case Api_WriteReadArray:
+        #if STREAM_WRITE_ARRAY && STREAM_READ_ARRAY
+            Queue_writeArray(queue, items, batch);
+            Queue_readArray(queue, items, batch);
+            return batch;
+        #else
+            return 0;
+        #endif
+        case Api_QueryArray:
+            Queue_writeQueryArray(queue, batch, writeQueryFn);
+            Queue_readQueryArray(queue, batch, readQueryFn);
+            return batch;
+        case Api_QueryBatch:
+            Queue_writeQueryBatch(queue, batch, writeBatchFn);
+            Queue_readQueryBatch(queue, batch, readBatchFn);
+            return batch;
+        case Api_WriteQueue:
+        #if STREAM_WRITE_STREAM
+            for (i = 0; i < batch; i++) {
+                Queue_write(other, &items[i * queue->ItemSize]);
+            }
+            Queue_writeQueue(queue, other, batch);
+            Queue_readQueryBatch(queue, batch, readBatchFn);
+            return batch;
+        #else
+            (void) other;
+            return 0;
+        #endif
+        default:
+            return 0;
+    }
+}
+
+static void benchSingle(Samples* samples, int limit) {
+    static uint8_t items[BENCH_MAX_ITEM_SIZE * BENCH_BATCH];
+    size_t s, b;
+    int api;
+
+    for (api = 0; api < Api_Count; api++) {
+        for (s = 0; s < ARRAY_LEN(ITEM_SIZES); s++) {
+            for (b = 0; b < ARRAY_LEN(BUFFER_ITEMS); b++) {
+                Queue_LenType itemSize = ITEM_SIZES[s];
+                Queue_LenType bufferItems = BUFFER_ITEMS[b];
+                Queue_LenType batch = api == Api_WriteRead ? 1 : BENCH_BATCH;
+                uint8_t* buffer = (uint8_t*) malloc((size_t) (itemSize * bufferItems));
+                uint8_t* otherBuffer = (uint8_t*) malloc((size_t) (itemSize * bufferItems));
+                Queue queue;
+                Queue other;
+                Result result;
+                uint64_t moved = 0;
+                uint64_t round = 0;
+                uint64_t start;
+
+                Queue_init(&queue, buffer, itemSize * bufferItems, itemSize);
+                Queue_init(&other, otherBuffer, itemSize * bufferItems, itemSize);
+                setLimits(&queue, limit);
+                samples->Len = 0;
+
+                start = nowNs();
+                while (moved < benchItems) {
+                    Queue_LenType len;
+                    refreshLimits(&queue, limit);
+                    if ((round++ & BENCH_SAMPLE_MASK) == 0) {
+                        uint64_t t0 = nowNs();
+                        len = runRound((Api) api, &queue, &other, items, batch);
+                        Samples_add(samples, nowNs() - t0);
+                    }
+                    else {
+                        len = runRound((Api) api, &queue, &other, items, batch);
+                    }
+                    if (len == 0) {
+                        break;
+                    }
+                    moved += (uint64_t) len;
+                }
+
+                result.Bench = "single";
+                result.Api = API_NAMES[api];
+                result.ItemSize = itemSize;
+                result.BufferItems = bufferItems;
+                result.Batch = batch;
+                result.Producers = 1;
+                result.Consumers = 1;
+                result.Limit = limit;
+                result.Items = moved;
+                result.Time = nowNs() - start;
+                if (moved > 0) {
+                    report(&result, samples);
+                }
+
+                Queue_deinit(&queue);
+                Queue_deinit(&other);
+                free(buffer);
+                free(otherBuffer);
+            }
+        }
+    }
+}
+
+// -------------------------- Threads ----------------------------
+typedef enum {
+    Kind_QueueMutex,
+    Kind_SPSC,
+    Kind_MPMC,
+} Kind;
+
+typedef struct {
+    Kind                Kind;
+    Queue               Queue;
+    pthread_mutex_t     Mutex;
+#if QUEUE_SPSC
+    QueueSPSC           SPSC;
+#endif
+#if QUEUE_MPMC
+    QueueMPMC           MPMC;
+#endif
+    Queue_LenType       ItemSize;
+    unsigned long       ItemsPerThread;
+} Shared;
+
+typedef struct {
+    Shared*             Shared;
+    Samples             Samples;
+} Worker;
+
+static Queue_Result sharedWrite(Shared* shared, const void* item) {
+    Queue_Result res = Queue_NoSpace;
+    switch (shared->Kind) {
+        case Kind_QueueMutex:
+            pthread_mutex_lock(&shared->Mutex);
+            res = Queue_write(&shared->Queue, item);
+            pthread_mutex_unlock(&shared->Mutex);
+            break;
+    #if QUEUE_SPSC
+        case Kind_SPSC:
+            res = QueueSPSC_write(&shared->SPSC, item);
+            break;
+    #endif
+    #if QUEUE_MPMC
+        case Kind_MPMC:
+            res = QueueMPMC_write(&shared->MPMC, item);
+            break;
+    #endif
+        default:
+            break;
+    }
+    return res;
+}
+
+static Queue_Result sharedRead(Shared* shared, void* item) {
+    Queue_Result res = Queue_NoAvailable;
+    switch (shared->Kind) {
+        case Kind_QueueMutex:
+            pthread_mutex_lock(&shared->Mutex);
+            res = Queue_read(&shared->Queue, item);
+            pthread_mutex_unlock(&shared->Mutex);
+            break;
+    #if QUEUE_SPSC
+        case Kind_SPSC:
+            res = QueueSPSC_read(&shared->SPSC, item);
+            break;
+    #endif
+    #if QUEUE_MPMC
+        case Kind_MPMC:
+            res = QueueMPMC_read(&shared->MPMC, item);
+            break;
+    #endif
+        default:
+            break;
+    }
+    return res;
+}
+
+static void* producerThread(void* arg) {
+    Worker* worker = (Worker*) arg;
+    Shared* shared = worker->Shared;
+    uint8_t item[BENCH_MAX_ITEM_SIZE];
+    unsigned long i;
+
+    memset(item, 0xA5, sizeof(item));
+    for (i = 0; i < shared->ItemsPerThread; i++) {
+        uint64_t ts = nowNs();
+        memcpy(item, &ts, sizeof(ts));
+        while (sharedWrite(shared, item) != Queue_Ok) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void* consumerThread(void* arg) {
+    Worker* worker = (Worker*) arg;
+    Shared* shared = worker->Shared;
+    uint8_t item[BENCH_MAX_ITEM_SIZE];
+    unsigned long i;
+
+    for (i = 0; i < shared->ItemsPerThread; i++) {
+        uint64_t ts;
+        while (sharedRead(shared, item) != Queue_Ok) {
+            sched_yield();
+        }
+        if ((i & BENCH_SAMPLE_MASK) == 0) {
+            memcpy(&ts, item, sizeof(ts));
+            Samples_add(&worker->Samples, nowNs() - ts);
+        }
+    }
+    return NULL;
+}
+
+static void benchThreads(Kind kind, const char* name, int maxPairs, Samples* samples) {
+    size_t s, b, p;
+
+    for (p = 0; p < ARRAY_LEN(THREAD_PAIRS) && THREAD_PAIRS[p] <= maxPairs; p++) {
+        for (s = 0; s < ARRAY_LEN(ITEM_SIZES); s++) {
+            for (b = 0; b < ARRAY_LEN(BUFFER_ITEMS); b++) {
+                int pairs = THREAD_PAIRS[p];
+                Queue_LenType itemSize = ITEM_SIZES[s];
+                Queue_LenType bufferItems = BUFFER_ITEMS[b];
+                size_t bufferSize = (size_t) itemSize * (size_t) bufferItems;
+                pthread_t threads[BENCH_MAX_THREADS * 2];
+                Worker workers[BENCH_MAX_THREADS * 2];
+                Shared shared;
+                Result result;
+                uint64_t start;
+                void* buffer;
+                int i;
+
+                memset(&shared, 0, sizeof(shared));
+                shared.Kind = kind;
+                shared.ItemSize = itemSize;
+                shared.ItemsPerThread = benchThreadItems / (unsigned long) pairs;
+                switch (kind) {
+                    case Kind_QueueMutex:
+                        buffer = malloc(bufferSize);
+                        Queue_init(&shared.Queue, buffer, (Queue_LenType) bufferSize, itemSize);
+                        pthread_mutex_init(&shared.Mutex, NULL);
+                        break;
+                #if QUEUE_SPSC
+                    case Kind_SPSC:
+                        buffer = malloc(bufferSize);
+                        if (QueueSPSC_init(&shared.SPSC, buffer, (Queue_LenType) bufferSize, itemSize) != Queue_Ok) {
+                            fprintf(stderr, "error: QueueSPSC_init, buffer size %lu\n", (unsigned long) bufferSize);
+                            exit(1);
+                        }
+                        break;
+                #endif
+                #if QUEUE_MPMC
+                    case Kind_MPMC:
+                        bufferSize = QueueMPMC_bufferSize((size_t) bufferItems, (size_t) itemSize);
+                        buffer = aligned_alloc(QUEUE_CACHE_LINE_SIZE, bufferSize);
+                        if (QueueMPMC_init(&shared.MPMC, buffer, (Queue_LenType) bufferSize, itemSize) != Queue_Ok) {
+                            fprintf(stderr, "error: QueueMPMC_init, buffer size %lu\n", (unsigned long) bufferSize);
+                            exit(1);
+                        }
+                        break;
+                #endif
+                    default:
+                        return;
+                }
+
+                // each worker own a slice of samples, consumer slices merged after join
+                samples->Len = 0;
+                start = nowNs();
+                for (i = 0; i < pairs * 2; i++) {
+                    workers[i].Shared = &shared;
+                    workers[i].Samples.Values = samples->Values + (BENCH_MAX_SAMPLES / (BENCH_MAX_THREADS * 2)) * i;
+                    workers[i].Samples.Len = 0;
+                    workers[i].Samples.Cap = BENCH_MAX_SAMPLES / (BENCH_MAX_THREADS * 2);
+                    pthread_create(&threads[i], NULL, i < pairs ? producerThread : consumerThread, &workers[i]);
+                }
+                for (i = 0; i < pairs * 2; i++) {
+                    pthread_join(threads[i], NULL);
+                }
+                result.Time = nowNs() - start;
+                // merge consumer slices at start of samples, destination never pass source
+                for (i = pairs; i < pairs * 2; i++) {
+                    memmove(&samples->Values[samples->Len], workers[i].Samples.Values,
+                            workers[i].Samples.Len * sizeof(uint64_t));
+                    samples->Len += workers[i].Samples.Len;
+                }
+
+                result.Bench = "threads";
+                result.Api = name;
+                result.ItemSize = itemSize;
+                result.BufferItems = bufferItems;
+                result.Batch = 1;
+                result.Producers = pairs;
+                result.Consumers = pairs;
+                result.Limit = 0;
+                result.Items = (uint64_t) shared.ItemsPerThread * (uint64_t) pairs;
+                report(&result, samples);
+
+                if (kind == Kind_QueueMutex) {
+                    pthread_mutex_destroy(&shared.Mutex);
+                }
+                free(buffer);
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Samples samples;
+
+    if (argc > 1 && strcmp(argv[1], "-q") == 0) {
+        benchItems /= 16;
+        benchThreadItems /= 16;
+    }
+
+    samples.Values = (uint64_t*) malloc(BENCH_MAX_SAMPLES * sizeof(uint64_t));
+    samples.Len = 0;
+    samples.Cap = BENCH_MAX_SAMPLES;
+
+    printConfig();
+
+    benchSingle(&samples, 0);
+#if STREAM_WRITE_LIMIT || STREAM_READ_LIMIT
+    benchSingle(&samples, 1);
+#endif
+
+    benchThreads(Kind_QueueMutex, "Queue+pthread_mutex", 1, &samples);
+#if QUEUE_SPSC
+    benchThreads(Kind_SPSC, "QueueSPSC", 1, &samples);
+#endif
+#if QUEUE_MPMC
+    benchThreads(Kind_MPMC, "QueueMPMC", BENCH_MAX_THREADS, &samples);
+#endif
+
+    free(samples.Values);
+    return 0;
+}
@@ -0,0 +1,242 @@
+#include "PriorityQueue.h"
+
+#if QUEUE_PRIORITY && QUEUE
+
+#include "QueueAtomic.h"
+
+#define __PriorityQueue_bit(LEVEL)                  ((PriorityQueue_Mask) 1 << (LEVEL))
+#define __PriorityQueue_first(MASK)                 ((uint8_t) __builtin_ctzll(MASK))
+
+/**
+ * @brief start new round, give all levels their weight as credit
+ */
+static void __PriorityQueue_refill(PriorityQueue* pq) {
+    uint8_t i;
+
+    for (i = 0; i < pq->Count; i++) {
+        pq->Credits[i] = pq->Weights[i];
+    }
+    pq->Ready = pq->Count == sizeof(PriorityQueue_Mask) * 8 ? ~(PriorityQueue_Mask) 0 : __PriorityQueue_bit(pq->Count) - 1;
+}
+/**
+ * @brief clear bit of empty level, then check level again
+ * because a writer may write between our empty check and clear
+ */
+static void __PriorityQueue_clear(PriorityQueue* pq, uint8_t level) {
+    Queue_atomicAnd(&pq->NonEmpty, ~__PriorityQueue_bit(level), QUEUE_SEQ_CST);
+    if (!Queue_isEmpty(&pq->Levels[level])) {
+        Queue_atomicOr(&pq->NonEmpty, __PriorityQueue_bit(level), QUEUE_SEQ_CST);
+    }
+}
+/**
+ * @brief return level that must be read next, -1 if all levels are empty
+ */
+static int16_t __PriorityQueue_next(PriorityQueue* pq) {
+    PriorityQueue_Mask mask = Queue_atomicLoad(&pq->NonEmpty, QUEUE_ACQUIRE);
+
+    if (mask == 0) {
+        return -1;
+    }
+    if (pq->Fair) {
+        if ((mask & pq->Ready) == 0) {
+            __PriorityQueue_refill(pq);
+        }
+        mask &= pq->Ready;
+    }
+    return __PriorityQueue_first(mask);
+}
+/**
+ * @brief read up to len items from one level
+ *
+ * @return Queue_LenType number of items read
+ */
+static Queue_LenType __PriorityQueue_readLevel(Queue* queue, uint8_t* val, Queue_LenType len) {
+#if STREAM_READ_ARRAY
+    return Queue_readArray(queue, val, len) == Queue_Ok ? len : 0;
+#else
+    Queue_LenType i;
+
+    for (i = 0; i < len; i++) {
+        if (Queue_read(queue, val) != Queue_Ok) {
+            break;
+        }
+        val += queue->ItemSize;
+    }
+    return i;
+#endif // STREAM_READ_ARRAY
+}
+/**
+ * @brief initialize priority queue, levels must be initialized before
+ * and have same item size, weights are disabled by default
+ *
+ * @param pq address of priority queue struct
+ * @param levels array of count Queue, index 0 is highest priority
+ * @param count number of levels, maximum QUEUE_PRIORITY_MAX_LEVELS
+ */
+void PriorityQueue_init(PriorityQueue* pq, Queue* levels, uint8_t count) {
+    uint8_t i;
+
+    if (count > QUEUE_PRIORITY_MAX_LEVELS) {
+        count = QUEUE_PRIORITY_MAX_LEVELS;
+    }
+    pq->Levels = levels;
+    pq->Count = count;
+    pq->Fair = 0;
+    pq->NonEmpty = 0;
+    for (i = 0; i < count; i++) {
+        pq->Weights[i] = 1;
+        if (!Queue_isEmpty(&levels[i])) {
+            pq->NonEmpty |= __PriorityQueue_bit(i);
+        }
+    }
+    __PriorityQueue_refill(pq);
+}
+/**
+ * @brief de-initialize priority queue, levels are not touched
+ *
+ * @param pq
+ */
+void PriorityQueue_deinit(PriorityQueue* pq) {
+    pq->Levels = NULL;
+    pq->Count = 0;
+    pq->Fair = 0;
+    pq->NonEmpty = 0;
+    pq->Ready = 0;
+}
+/**
+ * @brief set weights of levels, each level read at most weights[n] items per round,
+ * a round finish when all non-empty levels used their credits
+ * weight 0 is treated as 1
+ *
+ * @param pq
+ * @param weights array of Count weights, NULL for strict priority
+ */
+void PriorityQueue_setWeights(PriorityQueue* pq, const PriorityQueue_Weight* weights) {
+    uint8_t i;
+
+    pq->Fair = weights != NULL;
+    for (i = 0; i < pq->Count; i++) {
+        pq->Weights[i] = weights != NULL && weights[i] != 0 ? weights[i] : 1;
+    }
+    __PriorityQueue_refill(pq);
+}
+/**
+ * @brief return number of items in all levels, it's a snapshot
+ *
+ * @param pq
+ * @return Queue_LenType
+ */
+Queue_LenType PriorityQueue_available(PriorityQueue* pq) {
+    PriorityQueue_Mask mask = Queue_atomicLoad(&pq->NonEmpty, QUEUE_ACQUIRE);
+    Queue_LenType len = 0;
+    uint8_t level;
+
+    while (mask != 0) {
+        level = __PriorityQueue_first(mask);
+        mask &= mask - 1;
+        len += Queue_available(&pq->Levels[level]);
+    }
+    return len;
+}
+/**
+ * @brief write one item into given level
+ *
+ * @param pq
+ * @param level level index, 0 is highest priority
+ * @param val address of item
+ * @return Queue_Result Queue_NoSpace if level is out of range or level is full
+ */
+Queue_Result PriorityQueue_write(PriorityQueue* pq, uint8_t level, const void* val) {
+    Queue_Result res;
+
+    if (level >= pq->Count) {
+        return Queue_NoSpace;
+    }
+    res = Queue_write(&pq->Levels[level], val);
+    if (res == Queue_Ok) {
+        Queue_atomicOr(&pq->NonEmpty, __PriorityQueue_bit(level), QUEUE_SEQ_CST);
+    }
+    return res;
+}
+#if STREAM_WRITE_ARRAY
+/**
+ * @brief write array of items into given level
+ *
+ * @param pq
+ * @param level level index, 0 is highest priority
+ * @param val address of items
+ * @param len number of items
+ * @return Queue_Result Queue_NoSpace if level is out of range or level is full
+ */
+Queue_Result PriorityQueue_writeArray(PriorityQueue* pq, uint8_t level, const void* val, Queue_LenType len) {
+    Queue_Result res;
+
+    if (level >= pq->Count) {
+        return Queue_NoSpace;
+    }
+    res = Queue_writeArray(&pq->Levels[level], val, len);
+    if (res == Queue_Ok) {
+        Queue_atomicOr(&pq->NonEmpty, __PriorityQueue_bit(level), QUEUE_SEQ_CST);
+    }
+    return res;
+}
+#endif // STREAM_WRITE_ARRAY
+/**
+ * @brief read one item from highest priority level that has items
+ *
+ * @param pq
+ * @param val address of output item
+ * @return Queue_Result
+ */
+Queue_Result PriorityQueue_read(PriorityQueue* pq, void* val) {
+    return PriorityQueue_readArray(pq, val, 1) > 0 ? Queue_Ok : Queue_NoAvailable;
+}
+/**
+ * @brief read up to len items across levels, higher levels first,
+ * with weights each level give at most its remaining credit
+ *
+ * @param pq
+ * @param val address of output items
+ * @param len maximum number of items
+ * @return Queue_LenType number of items read, 0 if all levels are empty
+ */
+Queue_LenType PriorityQueue_readArray(PriorityQueue* pq, void* val, Queue_LenType len) {
+    uint8_t* out = (uint8_t*) val;
+    Queue_LenType count = 0;
+    Queue_LenType n;
+    Queue* queue;
+    int16_t level;
+
+    while (count < len && (level = __PriorityQueue_next(pq)) >= 0) {
+        queue = &pq->Levels[level];
+        n = Queue_available(queue);
+        if (n == 0) {
+            __PriorityQueue_clear(pq, (uint8_t) level);
+            continue;
+        }
+        if (n > len - count) {
+            n = len - count;
+        }
+        if (pq->Fair && n > pq->Credits[level]) {
+            n = pq->Credits[level];
+        }
+        n = __PriorityQueue_readLevel(queue, out, n);
+        if (n == 0) {
+            break;
+        }
+        out += n * queue->ItemSize;
+        count += n;
+        if (pq->Fair) {
+            pq->Credits[level] -= (PriorityQueue_Weight) n;
+            if (pq->Credits[level] == 0) {
+                pq->Ready &= ~__PriorityQueue_bit(level);
+            }
+        }
+        if (Queue_isEmpty(queue)) {
+            __PriorityQueue_clear(pq, (uint8_t) level);
+        }
+    }
+    return count;
+}
+
+#endif // QUEUE_PRIORITY
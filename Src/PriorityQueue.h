@@ -0,0 +1,119 @@
+/**
+ * @file PriorityQueue.h
+ * @author Ali Mirghasemi (ali.mirghasemi1376@gmail.com)
+ * @brief multi-level priority queue on top of Queue with O(1) level select
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * PriorityQueue own up to QUEUE_PRIORITY_MAX_LEVELS Queue levels, level 0 is highest priority.
+ * A bitmap hold one bit per non-empty level, writer set bit after write
+ * and reader clear it when level is empty, so highest non-empty level is found with
+ * count trailing zeros instead of scanning levels.
+ * Strict mode always drain highest level first, with weights each level can read
+ * at most weight items per round before lower levels get their turn, so bulk
+ * traffic is not starved by control traffic.
+ *
+ * Levels can have different buffer sizes, all levels must have same item size.
+ * Levels are plain Queue, so a writer can run in parallel with reader or with writers
+ * of same level only when STREAM_MUTEX is enabled, otherwise use one context or serialize
+ * calls by caller. Writers of different levels only share bitmap that updated atomically.
+ * Readers must be serialized.
+ *
+ * Example:
+ *  Queue levels[3];
+ *  Queue_init(&levels[0], ctrlBuf, sizeof(ctrlBuf), sizeof(ctrlBuf[0]));
+ *  ...
+ *  PriorityQueue_init(&pq, levels, 3);
+ *  PriorityQueue_write(&pq, 2, &msg);
+ *  PriorityQueue_read(&pq, &msg);
+ */
+#ifndef _PRIORITY_QUEUE_H_
+#define _PRIORITY_QUEUE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Queue.h"
+
+/************************************************************************/
+/*                            Configuration                             */
+/************************************************************************/
+/**
+ * @brief enable priority queue library
+ */
+#ifndef QUEUE_PRIORITY
+    #define QUEUE_PRIORITY                          0
+#endif
+/**
+ * @brief maximum number of levels, must be less than or equal 64
+ * up to 32 levels bitmaps are 32-bit, more levels need 64-bit atomics (libatomic on 32-bit targets)
+ */
+#ifndef QUEUE_PRIORITY_MAX_LEVELS
+    #define QUEUE_PRIORITY_MAX_LEVELS               64
+#endif
+/**
+ * @brief type of level weights and credits
+ */
+typedef uint16_t PriorityQueue_Weight;
+/************************************************************************/
+
+#if QUEUE_PRIORITY && QUEUE
+
+#if QUEUE_PRIORITY_MAX_LEVELS > 64
+    #error "QUEUE_PRIORITY_MAX_LEVELS must be less than or equal 64"
+#endif
+
+/**
+ * @brief bitmap of levels, one bit per level
+ */
+#if QUEUE_PRIORITY_MAX_LEVELS > 32
+    typedef uint64_t PriorityQueue_Mask;
+#else
+    typedef uint32_t PriorityQueue_Mask;
+#endif
+
+/**
+ * @brief PriorityQueue struct
+ */
+typedef struct {
+    PriorityQueue_Mask      NonEmpty;                               /**< bit n set when level n may have items */
+    PriorityQueue_Mask      Ready;                                  /**< bit n set when level n has credit in current round */
+    Queue*                  Levels;                                 /**< array of levels, level 0 is highest priority */
+    PriorityQueue_Weight    Weights[QUEUE_PRIORITY_MAX_LEVELS];     /**< items per round of each level */
+    PriorityQueue_Weight    Credits[QUEUE_PRIORITY_MAX_LEVELS];     /**< remaining items of each level in current round */
+    uint8_t                 Count;                                  /**< number of levels */
+    uint8_t                 Fair;                                   /**< weights enabled */
+} PriorityQueue;
+
+void                PriorityQueue_init(PriorityQueue* pq, Queue* levels, uint8_t count);
+void                PriorityQueue_deinit(PriorityQueue* pq);
+
+void                PriorityQueue_setWeights(PriorityQueue* pq, const PriorityQueue_Weight* weights);
+
+Queue_LenType       PriorityQueue_available(PriorityQueue* pq);
+
+#define             PriorityQueue_getLevel(PQ, LEVEL)                       (&(PQ)->Levels[(LEVEL)])
+#define             PriorityQueue_getLevelsCount(PQ)                        ((PQ)->Count)
+#define             PriorityQueue_isFair(PQ)                                ((PQ)->Fair)
+#define             PriorityQueue_isEmpty(PQ)                               (PriorityQueue_available(PQ) == 0)
+
+/**************** Write APIs **************/
+Queue_Result        PriorityQueue_write(PriorityQueue* pq, uint8_t level, const void* val);
+#if STREAM_WRITE_ARRAY
+    Queue_Result    PriorityQueue_writeArray(PriorityQueue* pq, uint8_t level, const void* val, Queue_LenType len);
+#endif // STREAM_WRITE_ARRAY
+
+/**************** Read APIs **************/
+Queue_Result        PriorityQueue_read(PriorityQueue* pq, void* val);
+Queue_LenType       PriorityQueue_readArray(PriorityQueue* pq, void* val, Queue_LenType len);
+
+#endif // QUEUE_PRIORITY
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _PRIORITY_QUEUE_H_ */
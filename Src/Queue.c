@@ -2,6 +2,36 @@
 
 #if QUEUE
 
+#if QUEUE_SPSC || QUEUE_HOOKS || QUEUE_PRE_HOOKS || QUEUE_RECORD
+    #include "QueueAtomic.h"
+    #include <string.h>
+#endif
+
+#if QUEUE_WAIT == QUEUE_WAIT_FUTEX
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <limits.h>
+    #include <time.h>
+#endif
+
+#if QUEUE_WAIT_EVENTFD
+    #include <sys/eventfd.h>
+    #include <unistd.h>
+#endif
+
+#if QUEUE_FD
+    #include <errno.h>
+    #include <sys/uio.h>
+#endif
+
+#if QUEUE_MIRROR
+    #include <linux/memfd.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
 #if !STREAM_WRITE
     #error "Queue library require STREAM_WRITE to be enabled"
 #endif
@@ -10,6 +40,14 @@
     #error "Queue library require STREAM_READ to be enabled"
 #endif
 
+#if QUEUE_WAIT_EVENTFD && !QUEUE_WAIT
+    #error "QUEUE_WAIT_EVENTFD require QUEUE_WAIT to be enabled"
+#endif
+
+#if QUEUE_WAIT
+static void __Queue_initWait(Queue* queue);
+#endif
+
 /**
  * @brief initialize queue
  *
@@ -20,6 +58,35 @@
 void Queue_init(Queue* queue, void* buffer, Queue_LenType size, Queue_LenType itemSize) {
     Stream_init(&queue->Buffer, buffer, size);
     queue->ItemSize = itemSize;
+#if QUEUE_WAIT
+    __Queue_initWait(queue);
+#endif
+#if QUEUE_MIRROR
+    queue->Mirrored = 0;
+#endif
+#if QUEUE_STATS
+    Queue_resetStats(queue);
+#endif
+#if QUEUE_OVERWRITE
+    queue->Dropped = 0;
+    queue->OverwriteSeq = 0;
+    queue->Overwrite = 0;
+#endif
+#if QUEUE_RECORD
+    queue->Reserved = 0;
+#endif
+#if QUEUE_FD
+    queue->FdWritePartial = 0;
+    queue->FdReadPartial = 0;
+    queue->FdWritePos = 0;
+    queue->FdReadPos = 0;
+#endif
+#if QUEUE_SOJOURN
+    queue->Stamps = NULL;
+    queue->Clock = NULL;
+    queue->LastSojourn = 0;
+    memset(&queue->Codel, 0, sizeof(queue->Codel));
+#endif
 }
 /**
  * @brief initialize queue with a buffer that already have data in it
@@ -31,6 +98,35 @@ void Queue_init(Queue* queue, void* buffer, Queue_LenType size, Queue_LenType it
 void Queue_fromBuff(Queue* queue, void* buffer, Queue_LenType size, Queue_LenType itemSize, Queue_LenType len) {
     Stream_fromBuff(&queue->Buffer, buffer, size, itemSize);
     queue->ItemSize = itemSize;
+#if QUEUE_WAIT
+    __Queue_initWait(queue);
+#endif
+#if QUEUE_MIRROR
+    queue->Mirrored = 0;
+#endif
+#if QUEUE_STATS
+    Queue_resetStats(queue);
+#endif
+#if QUEUE_OVERWRITE
+    queue->Dropped = 0;
+    queue->OverwriteSeq = 0;
+    queue->Overwrite = 0;
+#endif
+#if QUEUE_RECORD
+    queue->Reserved = 0;
+#endif
+#if QUEUE_FD
+    queue->FdWritePartial = 0;
+    queue->FdReadPartial = 0;
+    queue->FdWritePos = 0;
+    queue->FdReadPos = 0;
+#endif
+#if QUEUE_SOJOURN
+    queue->Stamps = NULL;
+    queue->Clock = NULL;
+    queue->LastSojourn = 0;
+    memset(&queue->Codel, 0, sizeof(queue->Codel));
+#endif
 }
 /**
  * @brief de-initialize queue
@@ -38,9 +134,126 @@ void Queue_fromBuff(Queue* queue, void* buffer, Queue_LenType size, Queue_LenTyp
  * @param queue 
  */
 void Queue_deinit(Queue* queue) {
+#if QUEUE_WAIT_EVENTFD
+    Queue_closeEventFd(queue);
+#endif
     Stream_deinit(&queue->Buffer);
     queue->ItemSize = 0;
 }
+#if QUEUE_OVERWRITE
+/**
+ * @brief initialize queue in overwrite mode, when queue is full write operations
+ * drop oldest items to make room instead of return Queue_NoSpace
+ * writer move read position, so reader and writer must be serialized by caller,
+ * reader can copy items from Queue_getReadPtr outside of lock and check
+ * Queue_wasOverwritten under lock before move read position
+ *
+ * @param queue address of queue struct
+ * @param buffer address of byte buffer
+ * @param size size of buffer
+ * @param itemSize size of each item
+ */
+void Queue_initOverwrite(Queue* queue, void* buffer, Queue_LenType size, Queue_LenType itemSize) {
+    Queue_init(queue, buffer, size, itemSize);
+    queue->Overwrite = 1;
+}
+#endif
+#if QUEUE_RECORD
+/**
+ * @brief initialize queue in record mode, use Queue_reserve/Queue_commit for write
+ * and Queue_peekRecord/Queue_release for read, item APIs must not be used on it
+ *
+ * @param queue address of queue struct
+ * @param buffer address of byte buffer, must be aligned to QUEUE_RECORD_ALIGN
+ * @param size size of buffer, rounded down to multiple of QUEUE_RECORD_ALIGN
+ */
+void Queue_initRecord(Queue* queue, void* buffer, Queue_LenType size) {
+    Queue_init(queue, buffer, size & ~((Queue_LenType) QUEUE_RECORD_ALIGN - 1), 1);
+}
+#endif
+#if QUEUE_MIRROR
+/**
+ * @brief greatest common divisor, used for align mirrored buffer to page and item size
+ */
+static size_t __Queue_gcd(size_t a, size_t b) {
+    size_t t;
+
+    while (b != 0) {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+/**
+ * @brief initialize queue with a mirrored buffer, same pages mapped twice back-to-back,
+ * so reads and writes are never split at wrap around and direct APIs return whole available/space
+ * buffer size rounded up to multiple of both page size and item size, so mirror boundary
+ * is always at an item boundary
+ *
+ * @param queue address of queue struct
+ * @param capacity minimum number of items
+ * @param itemSize size of each item
+ * @return Queue_Result Queue_Ok or Queue_CustomError if map failed
+ */
+Queue_Result Queue_initMirrored(Queue* queue, Queue_LenType capacity, Queue_LenType itemSize) {
+    long page = sysconf(_SC_PAGESIZE);
+    size_t size = (size_t) capacity * (size_t) itemSize;
+    size_t align;
+    uint8_t* base;
+    int fd;
+
+    if (page <= 0 || capacity <= 0 || itemSize <= 0) {
+        return Queue_CustomError;
+    }
+    // map size must be multiple of page size and item size
+    align = (size_t) page / __Queue_gcd((size_t) page, (size_t) itemSize) * (size_t) itemSize;
+    size = (size + align - 1) / align * align;
+    if (size == 0 || (Queue_LenType) size < 0 || (size_t) (Queue_LenType) size != size) {
+        return Queue_CustomError;
+    }
+
+    fd = (int) syscall(SYS_memfd_create, "queue", MFD_CLOEXEC);
+    if (fd < 0) {
+        return Queue_CustomError;
+    }
+    if (ftruncate(fd, (off_t) size) != 0) {
+        close(fd);
+        return Queue_CustomError;
+    }
+    // reserve address space for both views, then map file on each half
+    base = (uint8_t*) mmap(NULL, size << 1, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return Queue_CustomError;
+    }
+    if (mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+    ) {
+        munmap(base, size << 1);
+        close(fd);
+        return Queue_CustomError;
+    }
+    // mappings keep the memory alive
+    close(fd);
+
+    Queue_init(queue, base, (Queue_LenType) size, itemSize);
+    queue->Mirrored = 1;
+
+    return Queue_Ok;
+}
+/**
+ * @brief de-initialize queue that initialized with Queue_initMirrored and unmap its buffer
+ *
+ * @param queue
+ */
+void Queue_deinitMirrored(Queue* queue) {
+    if (queue->Mirrored) {
+        munmap(Queue_getBuffer(queue), (size_t) Queue_getBufferSizeRaw(queue) << 1);
+    }
+    Queue_deinit(queue);
+}
+#endif // QUEUE_MIRROR
 /**
  * @brief write item into queue with custom query function
  * 
@@ -50,9 +263,10 @@ void Queue_deinit(Queue* queue) {
  * @return Queue_Result 
  */
 Queue_Result Queue_writeQuery(Queue* queue, Queue_QueryFn query) {
+    __Queue_preWrite(queue, 1);
     // check available space for write
     if (Queue_spaceRaw(queue) < queue->ItemSize) {
-        return Queue_NoSpace;
+        return __Queue_writeHook(queue, Queue_NoSpace, 1);
     }
 #if STREAM_WRITE_LIMIT
     if (Queue_isWriteLimited(queue)) {
@@ -68,7 +282,7 @@ Queue_Result Queue_writeQuery(Queue* queue, Queue_QueryFn query) {
         res = Queue_moveWritePosRaw(queue, queue->ItemSize);
     }
 
-    return res;
+    return __Queue_writeHook(queue, res, 1);
 }
 /**
  * @brief write item into queue with custom query function
@@ -85,8 +299,9 @@ Queue_Result Queue_writeQueryArray(Queue* queue, Queue_LenType len, Queue_QueryF
       return Queue_ZeroLen;
     }
 #endif
+    __Queue_preWrite(queue, len);
     if (Queue_spaceRaw(queue) < len * queue->ItemSize) {
-        return Queue_NoSpace;
+        return __Queue_writeHook(queue, Queue_NoSpace, len);
     }
 #if STREAM_WRITE_LIMIT
     if (Queue_isWriteLimited(queue)) {
@@ -97,12 +312,80 @@ Queue_Result Queue_writeQueryArray(Queue* queue, Queue_LenType len, Queue_QueryF
     Queue_Result res = Queue_Ok;
     Queue_LenType i = 0;
 
-    while ((res = query(queue, Queue_getWritePtr(queue), i, len)) == Queue_Ok &&
-            ++i < len
+    while (i < len &&
+            (res = query(queue, Queue_getWritePtr(queue), i, len)) == Queue_Ok
     ) {
         // Move WPos
         res = Queue_moveWritePosRaw(queue, queue->ItemSize);
+        i++;
+    }
+
+#if QUEUE_HOOKS
+    if (i > 0) {
+        __Queue_onWrite(queue, Queue_Ok, i);
+    }
+#endif
+
+    return res;
+}
+/**
+ * @brief write items into queue with custom batch query function
+ * query called with at most two contiguous span of items, part before wrap around and part after it,
+ * write position and limit are updated once at the end for items that query accepted
+ *
+ * @param queue
+ * @param len number of items
+ * @param query
+ * @return Queue_Result
+ */
+Queue_Result Queue_writeQueryBatch(Queue* queue, Queue_LenType len, Queue_BatchQueryFn query) {
+    // check available space for write
+#if STREAM_CHECK_ZERO_LEN
+    if (len == 0) {
+      return Queue_ZeroLen;
+    }
+#endif
+    __Queue_preWrite(queue, len);
+    if (Queue_spaceRaw(queue) < len * queue->ItemSize) {
+        return __Queue_writeHook(queue, Queue_NoSpace, len);
+    }
+
+    Queue_Result res;
+    Queue_LenType count = Queue_directSpace(queue);
+    Queue_LenType done = 0;
+
+    if (count > len) {
+        count = len;
+    }
+    // first span, before wrap around
+    if ((res = query(queue, Queue_getWritePtr(queue), 0, count, len)) == Queue_Ok) {
+        done = count;
+        // second span, after wrap around
+        if (count < len &&
+            (res = query(queue, Queue_getWritePtrAt(queue, count), count, len - count, len)) == Queue_Ok
+        ) {
+            done = len;
+        }
+    }
+
+    if (done > 0) {
+    #if STREAM_WRITE_LIMIT
+        if (Queue_isWriteLimited(queue)) {
+            queue->Buffer.WriteLimit -= done * queue->ItemSize;
+        }
+    #endif
+        // Move WPos
+        Queue_Result moveRes = Queue_moveWritePosRaw(queue, done * queue->ItemSize);
+        if (res == Queue_Ok) {
+            res = moveRes;
+        }
+    }
+
+#if QUEUE_HOOKS
+    if (done > 0) {
+        __Queue_onWrite(queue, Queue_Ok, done);
     }
+#endif
 
     return res;
 }
@@ -115,9 +398,10 @@ Queue_Result Queue_writeQueryArray(Queue* queue, Queue_LenType len, Queue_QueryF
  * @return Queue_Result 
  */
 Queue_Result Queue_readQuery(Queue* queue, Queue_QueryFn query) {
+    __Queue_preRead(queue, 1);
     // check available bytes for read
     if (Queue_availableRaw(queue) < queue->ItemSize) {
-        return Queue_NoAvailable;
+        return __Queue_readHook(queue, Queue_NoAvailable, 1);
     }
 #if STREAM_READ_LIMIT
     if (Queue_isReadLimited(queue)) {
@@ -133,7 +417,7 @@ Queue_Result Queue_readQuery(Queue* queue, Queue_QueryFn query) {
         res = Queue_moveReadPosRaw(queue, queue->ItemSize);
     }
 
-    return res;
+    return __Queue_readHook(queue, res, 1);
 }
 
 /**
@@ -151,8 +435,9 @@ Queue_Result Queue_readQueryArray(Queue* queue, Queue_LenType len, Queue_QueryFn
         return Queue_ZeroLen;
     }
 #endif
+    __Queue_preRead(queue, len);
     if (Queue_availableRaw(queue) < len * queue->ItemSize) {
-        return Queue_NoAvailable;
+        return __Queue_readHook(queue, Queue_NoAvailable, len);
     }
 #if STREAM_READ_LIMIT
     if (Queue_isReadLimited(queue)) {
@@ -163,14 +448,1294 @@ Queue_Result Queue_readQueryArray(Queue* queue, Queue_LenType len, Queue_QueryFn
     Queue_Result res = Queue_Ok;
     Queue_LenType i = 0;
 
-    while ((res = query(queue, Queue_getReadPtr(queue), i, len)) == Queue_Ok &&
-            ++i < len
+    while (i < len &&
+            (res = query(queue, Queue_getReadPtr(queue), i, len)) == Queue_Ok
     ) {
         // Move RPos
         res = Queue_moveReadPosRaw(queue, queue->ItemSize);
+        i++;
+    }
+
+#if QUEUE_HOOKS
+    if (i > 0) {
+        __Queue_onRead(queue, Queue_Ok, i);
+    }
+#endif
+
+    return res;
+}
+/**
+ * @brief read items from queue with custom batch query function
+ * query called with at most two contiguous span of items, part before wrap around and part after it,
+ * read position and limit are updated once at the end for items that query accepted
+ *
+ * @param queue
+ * @param len number of items
+ * @param query
+ * @return Queue_Result
+ */
+Queue_Result Queue_readQueryBatch(Queue* queue, Queue_LenType len, Queue_BatchQueryFn query) {
+    // check available items for read
+#if STREAM_CHECK_ZERO_LEN
+    if (len == 0) {
+      return Queue_ZeroLen;
+    }
+#endif
+    __Queue_preRead(queue, len);
+    if (Queue_availableRaw(queue) < len * queue->ItemSize) {
+        return __Queue_readHook(queue, Queue_NoAvailable, len);
+    }
+
+    Queue_Result res;
+    Queue_LenType count = Queue_directAvailable(queue);
+    Queue_LenType done = 0;
+
+    if (count > len) {
+        count = len;
+    }
+    // first span, before wrap around
+    if ((res = query(queue, Queue_getReadPtr(queue), 0, count, len)) == Queue_Ok) {
+        done = count;
+        // second span, after wrap around
+        if (count < len &&
+            (res = query(queue, Queue_getReadPtrAt(queue, count), count, len - count, len)) == Queue_Ok
+        ) {
+            done = len;
+        }
+    }
+
+    if (done > 0) {
+    #if STREAM_READ_LIMIT
+        if (Queue_isReadLimited(queue)) {
+            queue->Buffer.ReadLimit -= done * queue->ItemSize;
+        }
+    #endif
+        // Move RPos
+        Queue_Result moveRes = Queue_moveReadPosRaw(queue, done * queue->ItemSize);
+        if (res == Queue_Ok) {
+            res = moveRes;
+        }
+    }
+
+#if QUEUE_HOOKS
+    if (done > 0) {
+        __Queue_onRead(queue, Queue_Ok, done);
+    }
+#endif
+
+    return res;
+}
+
+#if QUEUE_WAIT
+
+#if QUEUE_WAIT == QUEUE_WAIT_FUTEX
+static void __Queue_park(uint32_t* addr, uint32_t expected, uint32_t timeout) {
+    struct timespec ts;
+    ts.tv_sec = timeout / 1000;
+    ts.tv_nsec = (timeout % 1000) * 1000000L;
+    syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, timeout == QUEUE_WAIT_FOREVER ? NULL : &ts, NULL, 0);
+}
+static void __Queue_unpark(uint32_t* addr) {
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+static uint32_t __Queue_getTick(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t) (ts.tv_sec * 1000UL + ts.tv_nsec / 1000000L);
+}
+#elif QUEUE_WAIT == QUEUE_WAIT_CUSTOM
+static const Queue_WaitDriver* __waitDriver = NULL;
+/**
+ * @brief set park and wake functions, must be called before use wait APIs
+ *
+ * @param driver
+ */
+void Queue_setWaitDriver(const Queue_WaitDriver* driver) {
+    __waitDriver = driver;
+}
+
+#define __Queue_park(ADDR, EXPECTED, TIMEOUT)       __waitDriver->wait((ADDR), (EXPECTED), (TIMEOUT))
+#define __Queue_unpark(ADDR)                        __waitDriver->wake((ADDR))
+#define __Queue_getTick()                           __waitDriver->getTick()
+#else
+    #error "QUEUE_WAIT mode is not supported"
+#endif
+
+static void __Queue_initWait(Queue* queue) {
+    queue->ReadSeq = 0;
+    queue->WriteSeq = 0;
+    queue->ReadWaiters = 0;
+    queue->WriteWaiters = 0;
+#if QUEUE_WAIT_EVENTFD
+    queue->EventFd = -1;
+    queue->EventArmed = 0;
+#endif
+}
+/**
+ * @brief wake up waiters of other side, only touch futex when a waiter registered
+ */
+static void __Queue_notify(uint32_t* seq, uint32_t* waiters) {
+    if (Queue_atomicLoad(waiters, QUEUE_RELAXED) != 0) {
+        Queue_atomicAdd(seq, 1, QUEUE_RELEASE);
+        __Queue_unpark(seq);
+    }
+}
+/**
+ * @brief check queue is ready for read or write len bytes
+ */
+static uint8_t __Queue_ready(Queue* queue, uint8_t read, Queue_LenType len) {
+    return read ? Queue_availableRaw(queue) >= len : Queue_spaceRaw(queue) >= len;
+}
+/**
+ * @brief spin then park until queue ready for read or write len bytes or timeout
+ *
+ * @param queue
+ * @param read 1 for wait for read, 0 for wait for write
+ * @param len number of bytes
+ * @param start tick that wait started
+ * @param timeout timeout in ms
+ * @return Queue_Result
+ */
+static Queue_Result __Queue_wait(Queue* queue, uint8_t read, Queue_LenType len, uint32_t start, uint32_t timeout) {
+    uint32_t* seqPtr = read ? &queue->ReadSeq : &queue->WriteSeq;
+    uint32_t* waiters = read ? &queue->ReadWaiters : &queue->WriteWaiters;
+    uint32_t elapsed;
+    uint32_t seq;
+    int spin;
+
+    for (spin = 0; spin < QUEUE_WAIT_SPIN; spin++) {
+        if (__Queue_ready(queue, read, len)) {
+            return Queue_Ok;
+        }
+        Queue_cpuRelax();
+    }
+
+    for (;;) {
+        seq = Queue_atomicLoad(seqPtr, QUEUE_ACQUIRE);
+        // register as waiter before last check, other side check waiters after it changed queue
+        Queue_atomicAdd(waiters, 1, QUEUE_SEQ_CST);
+        Queue_atomicFence(QUEUE_SEQ_CST);
+        if (__Queue_ready(queue, read, len)) {
+            Queue_atomicSub(waiters, 1, QUEUE_RELAXED);
+            return Queue_Ok;
+        }
+        if (timeout == QUEUE_WAIT_FOREVER) {
+            __Queue_park(seqPtr, seq, QUEUE_WAIT_FOREVER);
+        }
+        else {
+            elapsed = __Queue_getTick() - start;
+            if (elapsed >= timeout) {
+                Queue_atomicSub(waiters, 1, QUEUE_RELAXED);
+                return read ? Queue_NoAvailable : Queue_NoSpace;
+            }
+            __Queue_park(seqPtr, seq, timeout - elapsed);
+        }
+        Queue_atomicSub(waiters, 1, QUEUE_RELAXED);
+    }
+}
+/**
+ * @brief called after successful write operations, wake up parked readers
+ */
+static void __Queue_wakeReaders(Queue* queue) {
+    // order written items before check waiters
+    Queue_atomicFence(QUEUE_SEQ_CST);
+    __Queue_notify(&queue->ReadSeq, &queue->ReadWaiters);
+#if QUEUE_WAIT_EVENTFD
+    if (queue->EventFd >= 0 &&
+        Queue_atomicLoad(&queue->EventArmed, QUEUE_RELAXED) != 0 &&
+        Queue_atomicExchange(&queue->EventArmed, 0, QUEUE_ACQ_REL) != 0
+    ) {
+        uint64_t one = 1;
+        (void) write(queue->EventFd, &one, sizeof(one));
+    }
+#endif
+}
+/**
+ * @brief called after successful read operations, wake up parked writers
+ */
+static void __Queue_wakeWriters(Queue* queue) {
+    // order read items before check waiters
+    Queue_atomicFence(QUEUE_SEQ_CST);
+    __Queue_notify(&queue->WriteSeq, &queue->WriteWaiters);
+}
+/**
+ * @brief write array of items into queue, block until there is space or timeout
+ *
+ * @param queue
+ * @param val address of items
+ * @param len number of items
+ * @param timeout timeout in ms, 0 for don't block, QUEUE_WAIT_FOREVER for no timeout
+ * @return Queue_Result
+ */
+Queue_Result Queue_writeArrayWait(Queue* queue, const void* val, Queue_LenType len, uint32_t timeout) {
+    Queue_Result res;
+    uint32_t start = 0;
+
+    while ((res = __Queue_writeHook(queue, __Queue_preWriteHook(queue, len, Stream_writeBytes(&queue->Buffer, (uint8_t*) val, len * queue->ItemSize)), len)) == Queue_NoSpace &&
+            timeout != 0
+    ) {
+        if (start == 0 && timeout != QUEUE_WAIT_FOREVER) {
+            start = __Queue_getTick();
+        }
+        if ((res = __Queue_wait(queue, 0, len * queue->ItemSize, start, timeout)) != Queue_Ok) {
+            break;
+        }
+    }
+
+    return res;
+}
+/**
+ * @brief read array of items from queue, block until items available or timeout
+ *
+ * @param queue
+ * @param val address of output items
+ * @param len number of items
+ * @param timeout timeout in ms, 0 for don't block, QUEUE_WAIT_FOREVER for no timeout
+ * @return Queue_Result
+ */
+Queue_Result Queue_readArrayWait(Queue* queue, void* val, Queue_LenType len, uint32_t timeout) {
+    Queue_Result res;
+    uint32_t start = 0;
+
+    while ((res = __Queue_readHook(queue, __Queue_preReadHook(queue, len, Stream_readBytes(&queue->Buffer, (uint8_t*) val, len * queue->ItemSize)), len)) == Queue_NoAvailable &&
+            timeout != 0
+    ) {
+        if (start == 0 && timeout != QUEUE_WAIT_FOREVER) {
+            start = __Queue_getTick();
+        }
+        if ((res = __Queue_wait(queue, 1, len * queue->ItemSize, start, timeout)) != Queue_Ok) {
+            break;
+        }
+    }
+
+    return res;
+}
+
+#if QUEUE_WAIT_EVENTFD
+/**
+ * @brief open eventfd that become readable when queue goes non-empty,
+ * after wake up consumer must call Queue_armEventFd and drain queue until it return 0
+ *
+ * @param queue
+ * @return int fd or -1 on error
+ */
+int Queue_openEventFd(Queue* queue) {
+    if (queue->EventFd < 0) {
+        queue->EventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        Queue_atomicStore(&queue->EventArmed, 0, QUEUE_RELEASE);
+    }
+    return queue->EventFd;
+}
+/**
+ * @brief close eventfd of queue
+ *
+ * @param queue
+ */
+void Queue_closeEventFd(Queue* queue) {
+    if (queue->EventFd >= 0) {
+        close(queue->EventFd);
+        queue->EventFd = -1;
+    }
+}
+/**
+ * @brief clear eventfd and arm it for next empty to non-empty transition
+ * return number of items that available now, if it's not zero consumer must read them
+ * and call this function again before go back to poll
+ *
+ * @param queue
+ * @return Queue_LenType available items
+ */
+Queue_LenType Queue_armEventFd(Queue* queue) {
+    uint64_t counter;
+    (void) read(queue->EventFd, &counter, sizeof(counter));
+    Queue_atomicStore(&queue->EventArmed, 1, QUEUE_SEQ_CST);
+    Queue_atomicFence(QUEUE_SEQ_CST);
+    return Queue_available(queue);
+}
+#endif // QUEUE_WAIT_EVENTFD
+
+#endif // QUEUE_WAIT
+
+#if QUEUE_STATS
+/**
+ * @brief update high watermark and occupancy histogram
+ *
+ * @param queue
+ * @param write 1 if called after write operation
+ */
+static void __Queue_statsOccupancy(Queue* queue, uint8_t write) {
+    Queue_StatsCounter items = (Queue_StatsCounter) Queue_available(queue);
+    uint8_t bucket = 0;
+
+    if (items != 0) {
+        bucket = (uint8_t) (sizeof(unsigned long) * 8 - __builtin_clzl((unsigned long) items));
+        if (bucket >= QUEUE_STATS_HISTOGRAM) {
+            bucket = QUEUE_STATS_HISTOGRAM - 1;
+        }
+    }
+    Queue_atomicAdd(&queue->Stats.Histogram[bucket], 1, QUEUE_RELAXED);
+
+    if (write) {
+        Queue_StatsCounter high = Queue_atomicLoad(&queue->Stats.HighWatermark, QUEUE_RELAXED);
+        while (items > high &&
+               !Queue_atomicCas(&queue->Stats.HighWatermark, &high, items, QUEUE_RELAXED, QUEUE_RELAXED)
+        ) {
+            // high reloaded by failed cas
+        }
+    }
+}
+/**
+ * @brief take snapshot of statistics, each counter read atomically
+ * but counters may be updated between them
+ *
+ * @param queue
+ * @param stats output
+ */
+void Queue_getStats(Queue* queue, Queue_Stats* stats) {
+    uint8_t i;
+
+    stats->Written = Queue_atomicLoad(&queue->Stats.Written, QUEUE_RELAXED);
+    stats->Read = Queue_atomicLoad(&queue->Stats.Read, QUEUE_RELAXED);
+    stats->NoSpace = Queue_atomicLoad(&queue->Stats.NoSpace, QUEUE_RELAXED);
+    stats->NoAvailable = Queue_atomicLoad(&queue->Stats.NoAvailable, QUEUE_RELAXED);
+    stats->WriteLimitHits = Queue_atomicLoad(&queue->Stats.WriteLimitHits, QUEUE_RELAXED);
+    stats->ReadLimitHits = Queue_atomicLoad(&queue->Stats.ReadLimitHits, QUEUE_RELAXED);
+    stats->HighWatermark = Queue_atomicLoad(&queue->Stats.HighWatermark, QUEUE_RELAXED);
+    for (i = 0; i < QUEUE_STATS_HISTOGRAM; i++) {
+        stats->Histogram[i] = Queue_atomicLoad(&queue->Stats.Histogram[i], QUEUE_RELAXED);
+    }
+}
+/**
+ * @brief clear all statistics counters
+ *
+ * @param queue
+ */
+void Queue_resetStats(Queue* queue) {
+    uint8_t i;
+
+    Queue_atomicStore(&queue->Stats.Written, 0, QUEUE_RELAXED);
+    Queue_atomicStore(&queue->Stats.Read, 0, QUEUE_RELAXED);
+    Queue_atomicStore(&queue->Stats.NoSpace, 0, QUEUE_RELAXED);
+    Queue_atomicStore(&queue->Stats.NoAvailable, 0, QUEUE_RELAXED);
+    Queue_atomicStore(&queue->Stats.WriteLimitHits, 0, QUEUE_RELAXED);
+    Queue_atomicStore(&queue->Stats.ReadLimitHits, 0, QUEUE_RELAXED);
+    Queue_atomicStore(&queue->Stats.HighWatermark, 0, QUEUE_RELAXED);
+    for (i = 0; i < QUEUE_STATS_HISTOGRAM; i++) {
+        Queue_atomicStore(&queue->Stats.Histogram[i], 0, QUEUE_RELAXED);
+    }
+}
+#endif // QUEUE_STATS
+
+#if QUEUE_OVERWRITE
+/**
+ * @brief drop oldest items until there is space for len items
+ * OverwriteSeq increased before items can be overwritten, so readers that copy items
+ * from read pointer can detect it with Queue_wasOverwritten
+ * read position is not moved atomically, caller serialize it with reads
+ */
+static void __Queue_makeRoom(Queue* queue, Queue_LenType len) {
+    Queue_LenType need = len * queue->ItemSize;
+    Queue_LenType drop;
+
+    if (need > Queue_getBufferSizeRaw(queue)) {
+        return;
+    }
+#if STREAM_WRITE_LIMIT
+    // dropping items can't help when write limit is not enough
+    if (Queue_isWriteLimited(queue) && Queue_getWriteLimitRaw(queue) < need) {
+        return;
+    }
+#endif
+    drop = need - Queue_spaceRaw(queue);
+    if (drop > 0) {
+        // round up to whole items
+        drop = (drop + queue->ItemSize - 1) / queue->ItemSize;
+        Queue_atomicAdd(&queue->OverwriteSeq, 1, QUEUE_RELAXED);
+        Queue_atomicFence(QUEUE_RELEASE);
+        if (Queue_moveReadPosRaw(queue, drop * queue->ItemSize) == Queue_Ok) {
+            Queue_atomicAdd(&queue->Dropped, (uint32_t) drop, QUEUE_RELAXED);
+        }
+    }
+}
+/**
+ * @brief return number of items that dropped by overwrite since init
+ *
+ * @param queue
+ * @return uint32_t
+ */
+uint32_t Queue_getDropped(Queue* queue) {
+    return Queue_atomicLoad(&queue->Dropped, QUEUE_RELAXED);
+}
+/**
+ * @brief take mark before copy items from Queue_getReadPtr, no lock needed
+ *
+ * @param queue
+ * @return uint32_t mark
+ */
+uint32_t Queue_overwriteMark(Queue* queue) {
+    return Queue_atomicLoad(&queue->OverwriteSeq, QUEUE_ACQUIRE);
+}
+/**
+ * @brief check after copy items from Queue_getReadPtr, if it return 1 copied items
+ * may be overwritten by writer and read position changed, discard copy and read again
+ *
+ * @param queue
+ * @param mark return value of Queue_overwriteMark
+ * @return uint8_t 1 if oldest items dropped since mark
+ */
+uint8_t Queue_wasOverwritten(Queue* queue, uint32_t mark) {
+    Queue_atomicFence(QUEUE_ACQUIRE);
+    return Queue_atomicLoad(&queue->OverwriteSeq, QUEUE_RELAXED) != mark;
+}
+#endif // QUEUE_OVERWRITE
+
+#if QUEUE_RECORD
+
+#define __QUEUE_RECORD_COMMITTED                    0x80000000UL
+#define __QUEUE_RECORD_PAD                          0x40000000UL
+
+#define __Queue_recordHeader(QUEUE, POS)            ((uint32_t*) ((uint8_t*) Queue_getBuffer(QUEUE) + (POS)))
+#define __Queue_recordSize(LEN)                     (QUEUE_RECORD_HEADER + (((LEN) + QUEUE_RECORD_ALIGN - 1) & ~((Queue_LenType) QUEUE_RECORD_ALIGN - 1)))
+
+/**
+ * @brief reserve contiguous space for a record of len bytes, header written in front of it
+ * more than one reservation can be outstanding, they can be committed in any order
+ * reserve and commit must be called from one producer context at a time
+ *
+ * @param queue
+ * @param len length of record in bytes
+ * @return void* address of record data, NULL if len is larger than buffer or there is no contiguous space
+ */
+void* Queue_reserve(Queue* queue, Queue_LenType len) {
+    Queue_LenType size = Queue_getBufferSizeRaw(queue);
+    Queue_LenType need;
+    Queue_LenType free;
+    Queue_LenType head;
+    Queue_LenType tail;
+    uint32_t* header;
+
+    // check len before round it up, so need can't overflow
+    if (len < 0 || (uint32_t) len > QUEUE_RECORD_MAX_LEN || len > size - QUEUE_RECORD_HEADER) {
+        return NULL;
+    }
+    need = __Queue_recordSize(len);
+    free = Queue_spaceRaw(queue) - queue->Reserved;
+    head = Queue_getWritePosRaw(queue) + queue->Reserved;
+    if (head >= size) {
+        head -= size;
+    }
+    tail = size - head;
+    if (tail < need) {
+        // record must be contiguous, fill tail with padding marker and start from beginning
+        if (free < tail + need) {
+            return NULL;
+        }
+        Queue_atomicStore(__Queue_recordHeader(queue, head), __QUEUE_RECORD_PAD | __QUEUE_RECORD_COMMITTED, QUEUE_RELAXED);
+        queue->Reserved += tail;
+        head = 0;
+    }
+    else if (free < need) {
+        return NULL;
+    }
+
+    header = __Queue_recordHeader(queue, head);
+    Queue_atomicStore(header, (uint32_t) len, QUEUE_RELAXED);
+    queue->Reserved += need;
+
+    return header + 1;
+}
+/**
+ * @brief mark reserved record as committed, then publish all committed records
+ * from write position in order, so a record is visible when records reserved before it committed too
+ *
+ * @param queue
+ * @param ptr return value of Queue_reserve
+ * @return Queue_Result
+ */
+Queue_Result Queue_commit(Queue* queue, void* ptr) {
+    Queue_LenType size = Queue_getBufferSizeRaw(queue);
+    uint32_t* header = (uint32_t*) ptr - 1;
+    Queue_LenType published = 0;
+
+    Queue_atomicStore(header, Queue_atomicLoad(header, QUEUE_RELAXED) | __QUEUE_RECORD_COMMITTED, QUEUE_RELEASE);
+
+    while (queue->Reserved > 0) {
+        Queue_LenType pos = Queue_getWritePosRaw(queue);
+        uint32_t value = Queue_atomicLoad(__Queue_recordHeader(queue, pos), QUEUE_ACQUIRE);
+        Queue_LenType step;
+
+        if ((value & __QUEUE_RECORD_COMMITTED) == 0) {
+            break;
+        }
+        if (value & __QUEUE_RECORD_PAD) {
+            step = size - pos;
+        }
+        else {
+            step = __Queue_recordSize((Queue_LenType) (value & QUEUE_RECORD_MAX_LEN));
+            published++;
+        }
+        queue->Reserved -= step;
+        // Move WPos
+        Queue_moveWritePosRaw(queue, step);
+    }
+
+#if QUEUE_HOOKS
+    if (published > 0) {
+        __Queue_onWrite(queue, Queue_Ok, published);
+    }
+#endif
+
+    return Queue_Ok;
+}
+/**
+ * @brief return first record without remove it, padding at end of buffer skipped
+ *
+ * @param queue
+ * @param len output length of record in bytes
+ * @return void* address of record data, NULL if queue is empty
+ */
+void* Queue_peekRecord(Queue* queue, Queue_LenType* len) {
+    Queue_LenType size = Queue_getBufferSizeRaw(queue);
+
+    while (Queue_availableRaw(queue) >= QUEUE_RECORD_HEADER) {
+        Queue_LenType pos = Queue_getReadPosRaw(queue);
+        uint32_t* header = __Queue_recordHeader(queue, pos);
+        uint32_t value = Queue_atomicLoad(header, QUEUE_ACQUIRE);
+
+        if (value & __QUEUE_RECORD_PAD) {
+            // Move RPos to beginning of buffer
+            Queue_moveReadPosRaw(queue, size - pos);
+            continue;
+        }
+        *len = (Queue_LenType) (value & QUEUE_RECORD_MAX_LEN);
+        return header + 1;
+    }
+
+    return NULL;
+}
+/**
+ * @brief remove first record
+ *
+ * @param queue
+ * @return Queue_Result
+ */
+Queue_Result Queue_release(Queue* queue) {
+    Queue_LenType len;
+
+    if (Queue_peekRecord(queue, &len) == NULL) {
+        return __Queue_readHook(queue, Queue_NoAvailable, 1);
+    }
+    // Move RPos
+    return __Queue_readHook(queue, Queue_moveReadPosRaw(queue, __Queue_recordSize(len)), 1);
+}
+#endif // QUEUE_RECORD
+
+#if QUEUE_SOJOURN
+/**
+ * @brief return 1 if time A is equal or after time B, wrap around is handled
+ */
+#define __Queue_timeAfterEq(A, B)                   ((Queue_TimeType) ((A) - (B)) < ((Queue_TimeType) 1 << (sizeof(Queue_TimeType) * 8 - 1)))
+#define __Queue_stampAt(QUEUE, POS)                 ((QUEUE)->Stamps[(POS) / (QUEUE)->ItemSize])
+
+/**
+ * @brief stamp len items start from pos with current time
+ */
+static void __Queue_stamp(Queue* queue, Queue_LenType pos, Queue_LenType len) {
+    Queue_LenType count = Queue_getBufferSize(queue);
+    Queue_LenType index = pos / queue->ItemSize;
+    Queue_TimeType now = queue->Clock();
+
+    while (len-- > 0) {
+        queue->Stamps[index] = now;
+        if (++index == count) {
+            index = 0;
+        }
+    }
+}
+/**
+ * @brief return sojourn time of oldest item, queue must not be empty
+ */
+static Queue_TimeType __Queue_sojournAt(Queue* queue, Queue_TimeType now) {
+    return now - __Queue_stampAt(queue, Queue_getReadPosRaw(queue));
+}
+/**
+ * @brief integer square root, used by CoDel control law
+ */
+static uint32_t __Queue_isqrt(uint32_t x) {
+    uint32_t res = 0;
+    uint32_t bit = (uint32_t) 1 << 30;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (x >= res + bit) {
+            x -= res + bit;
+            res = (res >> 1) + bit;
+        }
+        else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return res;
+}
+/**
+ * @brief CoDel control law, next drop is interval / sqrt(count) after t
+ */
+static Queue_TimeType __Queue_codelControl(Queue* queue, Queue_TimeType t) {
+    return t + queue->Codel.Interval / __Queue_isqrt(queue->Codel.Count);
+}
+/**
+ * @brief update sojourn of oldest item, return 1 when it stayed above target for an interval
+ * never allow drop when queue has len items or less, so read of caller don't fail because of policy
+ */
+static uint8_t __Queue_codelCheck(Queue* queue, Queue_TimeType now, Queue_LenType len) {
+    Queue_Codel* codel = &queue->Codel;
+
+    queue->LastSojourn = __Queue_sojournAt(queue, now);
+    if (queue->LastSojourn < codel->Target || Queue_availableRaw(queue) <= len * queue->ItemSize) {
+        codel->Above = 0;
+        return 0;
+    }
+    if (!codel->Above) {
+        codel->Above = 1;
+        codel->FirstAbove = now + codel->Interval;
+        return 0;
+    }
+    return __Queue_timeAfterEq(now, codel->FirstAbove);
+}
+/**
+ * @brief drop oldest item
+ */
+static void __Queue_codelDrop(Queue* queue) {
+    if (Queue_moveReadPosRaw(queue, queue->ItemSize) == Queue_Ok) {
+        Queue_atomicAdd(&queue->Codel.Dropped, 1, QUEUE_RELAXED);
+    }
+}
+/**
+ * @brief CoDel state machine (RFC 8289) run before read operations,
+ * drop oldest items while dropping state continue and next drop time is passed
+ */
+static void __Queue_codel(Queue* queue, Queue_TimeType now, Queue_LenType len) {
+    Queue_Codel* codel = &queue->Codel;
+    uint8_t drop = __Queue_codelCheck(queue, now, len);
+    uint32_t delta;
+
+    if (codel->Dropping) {
+        if (!drop) {
+            codel->Dropping = 0;
+        }
+        while (codel->Dropping && __Queue_timeAfterEq(now, codel->DropNext)) {
+            __Queue_codelDrop(queue);
+            codel->Count++;
+            if (!__Queue_codelCheck(queue, now, len)) {
+                codel->Dropping = 0;
+            }
+            else {
+                codel->DropNext = __Queue_codelControl(queue, codel->DropNext);
+            }
+        }
+    }
+    else if (drop) {
+        __Queue_codelDrop(queue);
+        (void) __Queue_codelCheck(queue, now, len);
+        codel->Dropping = 1;
+        // dropping state left recently, continue from previous drop rate
+        delta = codel->Count - codel->LastCount;
+        if (delta > 1 && (Queue_TimeType) (now - codel->DropNext) < 16 * codel->Interval) {
+            codel->Count = delta;
+        }
+        else {
+            codel->Count = 1;
+        }
+        codel->DropNext = __Queue_codelControl(queue, now);
+        codel->LastCount = codel->Count;
+    }
+}
+/**
+ * @brief enable sojourn time tracking, items that written after this call stamped with clock
+ * and items that already in queue stamped with current time
+ * stamps are set by item write APIs, record mode and direct write pointer APIs are not stamped
+ * buffer size must be multiple of item size, otherwise items are not aligned
+ * to stamps after wrap around
+ *
+ * @param queue
+ * @param stamps array of Queue_getBufferSize(queue) timestamps, NULL for disable
+ * @param clock monotonic clock
+ * @return Queue_Result Queue_CustomError if buffer size is not multiple of item size
+ * or clock is NULL, sojourn stay disabled in this case
+ */
+Queue_Result Queue_setSojourn(Queue* queue, Queue_TimeType* stamps, Queue_ClockFn clock) {
+    Queue_LenType count = Queue_getBufferSize(queue);
+    Queue_LenType i;
+
+    queue->Stamps = NULL;
+    queue->LastSojourn = 0;
+    if (stamps != NULL) {
+        if (clock == NULL || Queue_getBufferSizeRaw(queue) != count * queue->ItemSize) {
+            return Queue_CustomError;
+        }
+        Queue_TimeType now = clock();
+        for (i = 0; i < count; i++) {
+            stamps[i] = now;
+        }
+    }
+    queue->Clock = clock;
+    queue->Stamps = stamps;
+
+    return Queue_Ok;
+}
+/**
+ * @brief enable CoDel policy, when sojourn time of oldest item stay above target for an interval
+ * read operations drop oldest items, with drop rate increasing until sojourn fall below target
+ * require Queue_setSojourn
+ *
+ * @param queue
+ * @param target acceptable sojourn time, 0 for disable
+ * @param interval time that sojourn must stay above target before first drop, in clock unit
+ */
+void Queue_setCodel(Queue* queue, Queue_TimeType target, Queue_TimeType interval) {
+    memset(&queue->Codel, 0, sizeof(queue->Codel));
+    queue->Codel.Target = target;
+    queue->Codel.Interval = interval;
+}
+/**
+ * @brief return sojourn time of oldest item that is in queue now
+ *
+ * @param queue
+ * @return Queue_TimeType 0 if queue is empty or sojourn is disabled
+ */
+Queue_TimeType Queue_headSojourn(Queue* queue) {
+    if (queue->Stamps == NULL || Queue_isEmpty(queue)) {
+        return 0;
+    }
+    return __Queue_sojournAt(queue, queue->Clock());
+}
+/**
+ * @brief return number of items that dropped by CoDel policy since Queue_setCodel
+ *
+ * @param queue
+ * @return uint32_t
+ */
+uint32_t Queue_getCodelDropped(Queue* queue) {
+    return Queue_atomicLoad(&queue->Codel.Dropped, QUEUE_RELAXED);
+}
+#endif // QUEUE_SOJOURN
+
+#if QUEUE_FD
+/**
+ * @brief fill iovec with at most two segments of len bytes that start at pos, split at end of buffer
+ *
+ * @return int number of segments
+ */
+static int __Queue_fdSegments(Queue* queue, struct iovec* iov, Queue_LenType pos, Queue_LenType len) {
+    Queue_LenType size = Queue_getBufferSizeRaw(queue);
+    uint8_t* buf = (uint8_t*) Queue_getBuffer(queue);
+    Queue_LenType first;
+
+    if (pos >= size) {
+        pos -= size;
+    }
+    first = size - pos;
+    if (first > len) {
+        first = len;
+    }
+    iov[0].iov_base = buf + pos;
+    iov[0].iov_len = (size_t) first;
+    if (first < len) {
+        iov[1].iov_base = buf;
+        iov[1].iov_len = (size_t) (len - first);
+        return 2;
+    }
+    return 1;
+}
+/**
+ * @brief receive items from fd directly into queue with one readv over free space
+ * incomplete item is kept after write position and completed in next call,
+ * it's discarded if write position moved by other APIs since then
+ *
+ * @param queue
+ * @param fd file descriptor, socket or pipe
+ * @param maxItems maximum number of items to receive
+ * @return Queue_LenType number of items received, 0 if fd has no data (EAGAIN) or queue is full,
+ * QUEUE_FD_EOF on end of file, -1 on error with errno set
+ */
+Queue_LenType Queue_writeFromFd(Queue* queue, int fd, Queue_LenType maxItems) {
+    struct iovec iov[2];
+    Queue_LenType partial = queue->FdWritePartial;
+    Queue_LenType len = Queue_spaceRaw(queue);
+    Queue_LenType items;
+    ssize_t n;
+
+    // incomplete item overwritten by other write APIs
+    if (partial != 0 && queue->FdWritePos != Queue_getWritePosRaw(queue)) {
+        partial = 0;
+        queue->FdWritePartial = 0;
+    }
+    // clamp items before scale to bytes, maxItems * ItemSize can overflow
+    items = len / queue->ItemSize;
+    if (items > maxItems) {
+        items = maxItems;
+    }
+    len = items * queue->ItemSize - partial;
+    if (len <= 0) {
+        return 0;
+    }
+
+    n = readv(fd, iov, __Queue_fdSegments(queue, iov, Queue_getWritePosRaw(queue) + partial, len));
+    if (n < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+    }
+    else if (n == 0) {
+        return QUEUE_FD_EOF;
+    }
+
+    partial += (Queue_LenType) n;
+    items = partial / queue->ItemSize;
+    queue->FdWritePartial = partial - items * queue->ItemSize;
+    if (items > 0) {
+    #if STREAM_WRITE_LIMIT
+        if (Queue_isWriteLimited(queue)) {
+            queue->Buffer.WriteLimit -= items * queue->ItemSize;
+        }
+    #endif
+    #if QUEUE_SOJOURN
+        if (queue->Stamps != NULL) {
+            __Queue_stamp(queue, Queue_getWritePosRaw(queue), items);
+        }
+    #endif
+        // Move WPos
+        (void) __Queue_writeHook(queue, Queue_moveWritePosRaw(queue, items * queue->ItemSize), items);
+    }
+    queue->FdWritePos = Queue_getWritePosRaw(queue);
+
+    return items;
+}
+/**
+ * @brief send items from queue directly to fd with one writev over available items
+ * read position moved only for complete items, rest of partially sent item is sent in next call,
+ * if read position moved by other APIs since then, next item is sent from its beginning
+ *
+ * @param queue
+ * @param fd file descriptor, socket or pipe
+ * @param maxItems maximum number of items to send
+ * @return Queue_LenType number of items sent, 0 if fd is not ready (EAGAIN) or queue is empty,
+ * -1 on error with errno set
+ */
+Queue_LenType Queue_readToFd(Queue* queue, int fd, Queue_LenType maxItems) {
+    struct iovec iov[2];
+    Queue_LenType partial = queue->FdReadPartial;
+    Queue_LenType len;
+    Queue_LenType items;
+    ssize_t n;
+
+    // partially sent item removed by other read APIs
+    if (partial != 0 && queue->FdReadPos != Queue_getReadPosRaw(queue)) {
+        partial = 0;
+        queue->FdReadPartial = 0;
+    }
+    // oldest item can be dropped only when none of its bytes sent
+    if (partial == 0) {
+        __Queue_preRead(queue, 1);
+    }
+    len = Queue_availableRaw(queue);
+
+    // clamp items before scale to bytes, maxItems * ItemSize can overflow
+    items = len / queue->ItemSize;
+    if (items > maxItems) {
+        items = maxItems;
+    }
+    len = items * queue->ItemSize - partial;
+    if (len <= 0) {
+        return 0;
+    }
+
+    n = writev(fd, iov, __Queue_fdSegments(queue, iov, Queue_getReadPosRaw(queue) + partial, len));
+    if (n < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+    }
+
+    partial += (Queue_LenType) n;
+    items = partial / queue->ItemSize;
+    queue->FdReadPartial = partial - items * queue->ItemSize;
+    if (items > 0) {
+    #if STREAM_READ_LIMIT
+        if (Queue_isReadLimited(queue)) {
+            queue->Buffer.ReadLimit -= items * queue->ItemSize;
+        }
+    #endif
+        // Move RPos
+        (void) __Queue_readHook(queue, Queue_moveReadPosRaw(queue, items * queue->ItemSize), items);
+    }
+    queue->FdReadPos = Queue_getReadPosRaw(queue);
+
+    return items;
+}
+#endif // QUEUE_FD
+
+#if QUEUE_PRE_HOOKS
+/**
+ * @brief called before write operations, make room in overwrite mode
+ * and stamp items that will be written
+ *
+ * @param queue
+ * @param len number of items
+ */
+void __Queue_onPreWrite(Queue* queue, Queue_LenType len) {
+#if QUEUE_OVERWRITE
+    if (queue->Overwrite) {
+        __Queue_makeRoom(queue, len);
+    }
+#endif
+#if QUEUE_SOJOURN
+    // stamp only free items, stamps of queued items must not change when write fail
+    if (queue->Stamps != NULL && Queue_spaceRaw(queue) >= len * queue->ItemSize) {
+        __Queue_stamp(queue, Queue_getWritePosRaw(queue), len);
+    }
+#endif
+}
+#if QUEUE_SOJOURN
+/**
+ * @brief called before read operations, update sojourn time and run CoDel policy
+ * when read can be done
+ *
+ * @param queue
+ * @param len number of items
+ */
+void __Queue_onPreRead(Queue* queue, Queue_LenType len) {
+    Queue_TimeType now;
+
+    if (queue->Stamps == NULL || Queue_isEmpty(queue) || Queue_availableRaw(queue) < len * queue->ItemSize) {
+        return;
+    }
+    now = queue->Clock();
+    if (queue->Codel.Target != 0) {
+        __Queue_codel(queue, now, len);
+    }
+    else {
+        queue->LastSojourn = __Queue_sojournAt(queue, now);
+    }
+}
+#endif // QUEUE_SOJOURN
+#endif // QUEUE_PRE_HOOKS
+
+#if QUEUE_HOOKS
+/**
+ * @brief called after write operations, wake up parked readers and update statistics
+ *
+ * @param queue
+ * @param res result of write operation
+ * @param len number of items
+ * @return Queue_Result res
+ */
+Queue_Result __Queue_onWrite(Queue* queue, Queue_Result res, Queue_LenType len) {
+    (void) len;
+    if (res == Queue_Ok) {
+    #if QUEUE_STATS
+        Queue_atomicAdd(&queue->Stats.Written, (Queue_StatsCounter) len, QUEUE_RELAXED);
+        __Queue_statsOccupancy(queue, 1);
+    #endif
+    #if QUEUE_WAIT
+        __Queue_wakeReaders(queue);
+    #endif
+    }
+#if QUEUE_STATS
+    else if (res == Queue_NoSpace) {
+        Queue_atomicAdd(&queue->Stats.NoSpace, 1, QUEUE_RELAXED);
+    #if STREAM_WRITE_LIMIT
+        if (Queue_isWriteLimited(queue) && Queue_getWriteLimitRaw(queue) < len * queue->ItemSize) {
+            Queue_atomicAdd(&queue->Stats.WriteLimitHits, 1, QUEUE_RELAXED);
+        }
+    #endif
+    }
+#endif
+    return res;
+}
+/**
+ * @brief called after read operations, wake up parked writers and update statistics
+ *
+ * @param queue
+ * @param res result of read operation
+ * @param len number of items
+ * @return Queue_Result res
+ */
+Queue_Result __Queue_onRead(Queue* queue, Queue_Result res, Queue_LenType len) {
+    (void) len;
+    if (res == Queue_Ok) {
+    #if QUEUE_STATS
+        Queue_atomicAdd(&queue->Stats.Read, (Queue_StatsCounter) len, QUEUE_RELAXED);
+        __Queue_statsOccupancy(queue, 0);
+    #endif
+    #if QUEUE_WAIT
+        __Queue_wakeWriters(queue);
+    #endif
+    }
+#if QUEUE_STATS
+    else if (res == Queue_NoAvailable) {
+        Queue_atomicAdd(&queue->Stats.NoAvailable, 1, QUEUE_RELAXED);
+    #if STREAM_READ_LIMIT
+        if (Queue_isReadLimited(queue) && Queue_getReadLimitRaw(queue) < len * queue->ItemSize) {
+            Queue_atomicAdd(&queue->Stats.ReadLimitHits, 1, QUEUE_RELAXED);
+        }
+    #endif
+    }
+#endif
+    return res;
+}
+#endif // QUEUE_HOOKS
+
+#if QUEUE_SPSC
+/**
+ * @brief return number of bytes between read and write position
+ */
+static Queue_LenType __QueueSPSC_count(QueueSPSC* queue, Queue_LenType wpos, Queue_LenType rpos) {
+    Queue_LenType len = wpos - rpos;
+    return len < 0 ? len + (queue->Size << 1) : len;
+}
+/**
+ * @brief move position forward and wrap it in range [0, 2 * Size)
+ */
+static Queue_LenType __QueueSPSC_advance(QueueSPSC* queue, Queue_LenType pos, Queue_LenType len) {
+    pos += len;
+    return pos >= (queue->Size << 1) ? pos - (queue->Size << 1) : pos;
+}
+/**
+ * @brief convert position to address in buffer
+ */
+static uint8_t* __QueueSPSC_ptr(QueueSPSC* queue, Queue_LenType pos) {
+    return queue->Data + (pos >= queue->Size ? pos - queue->Size : pos);
+}
+/**
+ * @brief check space for write, only reload consumer position when cached one is not enough
+ */
+static Queue_LenType __QueueSPSC_space(QueueSPSC* queue, Queue_LenType wpos, Queue_LenType len) {
+    Queue_LenType space = queue->Size - __QueueSPSC_count(queue, wpos, queue->RPosCache);
+    if (space < len) {
+        queue->RPosCache = Queue_atomicLoad(&queue->RPos, QUEUE_ACQUIRE);
+        space = queue->Size - __QueueSPSC_count(queue, wpos, queue->RPosCache);
+    }
+    return space;
+}
+/**
+ * @brief check available bytes for read, only reload producer position when cached one is not enough
+ */
+static Queue_LenType __QueueSPSC_available(QueueSPSC* queue, Queue_LenType rpos, Queue_LenType len) {
+    Queue_LenType available = __QueueSPSC_count(queue, queue->WPosCache, rpos);
+    if (available < len) {
+        queue->WPosCache = Queue_atomicLoad(&queue->WPos, QUEUE_ACQUIRE);
+        available = __QueueSPSC_count(queue, queue->WPosCache, rpos);
+    }
+    return available;
+}
+/**
+ * @brief initialize SPSC queue
+ *
+ * @param queue address of queue struct
+ * @param buffer address of byte buffer
+ * @param size size of buffer, rounded down to multiple of itemSize
+ * @param itemSize size of each item
+ * @return Queue_Result Queue_Ok, or Queue_NoSpace if itemSize is not positive or buffer can't hold one item
+ */
+Queue_Result QueueSPSC_init(QueueSPSC* queue, void* buffer, Queue_LenType size, Queue_LenType itemSize) {
+    if (itemSize <= 0 || size < itemSize) {
+        QueueSPSC_deinit(queue);
+        return Queue_NoSpace;
+    }
+    queue->Data = (uint8_t*) buffer;
+    queue->Size = size - (size % itemSize);
+    queue->ItemSize = itemSize;
+    queue->WPos = 0;
+    queue->RPosCache = 0;
+    queue->RPos = 0;
+    queue->WPosCache = 0;
+    Queue_atomicFence(QUEUE_SEQ_CST);
+    return Queue_Ok;
+}
+/**
+ * @brief de-initialize SPSC queue
+ *
+ * @param queue
+ */
+void QueueSPSC_deinit(QueueSPSC* queue) {
+    queue->Data = NULL;
+    queue->Size = 0;
+    queue->ItemSize = 0;
+    queue->WPos = 0;
+    queue->RPosCache = 0;
+    queue->RPos = 0;
+    queue->WPosCache = 0;
+}
+/**
+ * @brief return number of items available for read,
+ * exact on consumer side, a snapshot on other threads
+ *
+ * @param queue
+ * @return Queue_LenType
+ */
+Queue_LenType QueueSPSC_available(QueueSPSC* queue) {
+    return __QueueSPSC_count(queue,
+                             Queue_atomicLoad(&queue->WPos, QUEUE_ACQUIRE),
+                             Queue_atomicLoad(&queue->RPos, QUEUE_ACQUIRE)) / queue->ItemSize;
+}
+/**
+ * @brief return number of free items for write,
+ * exact on producer side, a snapshot on other threads
+ *
+ * @param queue
+ * @return Queue_LenType
+ */
+Queue_LenType QueueSPSC_space(QueueSPSC* queue) {
+    return (queue->Size - __QueueSPSC_count(queue,
+                                            Queue_atomicLoad(&queue->WPos, QUEUE_ACQUIRE),
+                                            Queue_atomicLoad(&queue->RPos, QUEUE_ACQUIRE))) / queue->ItemSize;
+}
+/**
+ * @brief write array of items into queue, must only called from producer
+ *
+ * @param queue
+ * @param val address of items
+ * @param len number of items
+ * @return Queue_Result
+ */
+Queue_Result QueueSPSC_writeArray(QueueSPSC* queue, const void* val, Queue_LenType len) {
+#if STREAM_CHECK_ZERO_LEN
+    if (len == 0) {
+        return Queue_ZeroLen;
+    }
+#endif
+    Queue_LenType wpos = Queue_atomicLoad(&queue->WPos, QUEUE_RELAXED);
+    Queue_LenType part;
+    len *= queue->ItemSize;
+    // check available space for write
+    if (__QueueSPSC_space(queue, wpos, len) < len) {
+        return Queue_NoSpace;
+    }
+    // copy items, at most two part when wrap around
+    part = queue->Size - (wpos >= queue->Size ? wpos - queue->Size : wpos);
+    if (part >= len) {
+        memcpy(__QueueSPSC_ptr(queue, wpos), val, len);
+    }
+    else {
+        memcpy(__QueueSPSC_ptr(queue, wpos), val, part);
+        memcpy(queue->Data, (const uint8_t*) val + part, len - part);
+    }
+    // publish items
+    Queue_atomicStore(&queue->WPos, __QueueSPSC_advance(queue, wpos, len), QUEUE_RELEASE);
+
+    return Queue_Ok;
+}
+/**
+ * @brief write items into queue with custom query function, must only called from producer
+ * query called once per item with address of item in queue buffer,
+ * items that query accepted are published once at the end
+ *
+ * @param queue
+ * @param len number of items
+ * @param query
+ * @return Queue_Result
+ */
+Queue_Result QueueSPSC_writeQueryArray(QueueSPSC* queue, Queue_LenType len, QueueSPSC_QueryFn query) {
+#if STREAM_CHECK_ZERO_LEN
+    if (len == 0) {
+        return Queue_ZeroLen;
+    }
+#endif
+    Queue_LenType wpos = Queue_atomicLoad(&queue->WPos, QUEUE_RELAXED);
+    Queue_LenType pos = wpos;
+    Queue_Result res = Queue_Ok;
+    Queue_LenType i;
+    // check available space for write
+    if (__QueueSPSC_space(queue, wpos, len * queue->ItemSize) < len * queue->ItemSize) {
+        return Queue_NoSpace;
+    }
+
+    for (i = 0; i < len; i++) {
+        if ((res = query(queue, __QueueSPSC_ptr(queue, pos), i, len)) != Queue_Ok) {
+            break;
+        }
+        pos = __QueueSPSC_advance(queue, pos, queue->ItemSize);
+    }
+    // publish accepted items
+    if (pos != wpos) {
+        Queue_atomicStore(&queue->WPos, pos, QUEUE_RELEASE);
+    }
+
+    return res;
+}
+/**
+ * @brief read array of items from queue, must only called from consumer
+ *
+ * @param queue
+ * @param val address of output items
+ * @param len number of items
+ * @return Queue_Result
+ */
+Queue_Result QueueSPSC_readArray(QueueSPSC* queue, void* val, Queue_LenType len) {
+#if STREAM_CHECK_ZERO_LEN
+    if (len == 0) {
+        return Queue_ZeroLen;
+    }
+#endif
+    Queue_LenType rpos = Queue_atomicLoad(&queue->RPos, QUEUE_RELAXED);
+    Queue_LenType part;
+    len *= queue->ItemSize;
+    // check available items for read
+    if (__QueueSPSC_available(queue, rpos, len) < len) {
+        return Queue_NoAvailable;
+    }
+    // copy items, at most two part when wrap around
+    part = queue->Size - (rpos >= queue->Size ? rpos - queue->Size : rpos);
+    if (part >= len) {
+        memcpy(val, __QueueSPSC_ptr(queue, rpos), len);
+    }
+    else {
+        memcpy(val, __QueueSPSC_ptr(queue, rpos), part);
+        memcpy((uint8_t*) val + part, queue->Data, len - part);
+    }
+    // release space
+    Queue_atomicStore(&queue->RPos, __QueueSPSC_advance(queue, rpos, len), QUEUE_RELEASE);
+
+    return Queue_Ok;
+}
+/**
+ * @brief read items from queue with custom query function, must only called from consumer
+ * query called once per item with address of item in queue buffer,
+ * items that query accepted are released once at the end
+ *
+ * @param queue
+ * @param len number of items
+ * @param query
+ * @return Queue_Result
+ */
+Queue_Result QueueSPSC_readQueryArray(QueueSPSC* queue, Queue_LenType len, QueueSPSC_QueryFn query) {
+#if STREAM_CHECK_ZERO_LEN
+    if (len == 0) {
+        return Queue_ZeroLen;
+    }
+#endif
+    Queue_LenType rpos = Queue_atomicLoad(&queue->RPos, QUEUE_RELAXED);
+    Queue_LenType pos = rpos;
+    Queue_Result res = Queue_Ok;
+    Queue_LenType i;
+    // check available items for read
+    if (__QueueSPSC_available(queue, rpos, len * queue->ItemSize) < len * queue->ItemSize) {
+        return Queue_NoAvailable;
+    }
+
+    for (i = 0; i < len; i++) {
+        if ((res = query(queue, __QueueSPSC_ptr(queue, pos), i, len)) != Queue_Ok) {
+            break;
+        }
+        pos = __QueueSPSC_advance(queue, pos, queue->ItemSize);
+    }
+    // release accepted items
+    if (pos != rpos) {
+        Queue_atomicStore(&queue->RPos, pos, QUEUE_RELEASE);
     }
 
     return res;
 }
+#endif // QUEUE_SPSC
 
 #endif // QUEUE
@@ -34,6 +34,106 @@ extern "C" {
  * must be signed type
  */
 typedef Stream_LenType Queue_LenType;
+/**
+ * @brief enable lock-free single-producer/single-consumer queue (QueueSPSC)
+ * it's a separate struct that don't use StreamBuffer and don't need STREAM_MUTEX
+ * require GCC or Clang atomic builtins, disabled by default for other compilers
+ */
+#ifndef QUEUE_SPSC
+    #define QUEUE_SPSC                  0
+#endif
+/**
+ * @brief cache line size of target, used for keep producer and consumer fields
+ * of lock-free queues in separate cache lines
+ */
+#define QUEUE_CACHE_LINE_SIZE           64
+/**
+ * @brief enable blocking APIs (Queue_readWait, Queue_writeWait, ...)
+ * blocked side spin QUEUE_WAIT_SPIN times then park, other side only wake it
+ * when a waiter is registered, queue must be shared with STREAM_MUTEX enabled
+ * QUEUE_WAIT_NONE: disabled
+ * QUEUE_WAIT_FUTEX: park on linux futex
+ * QUEUE_WAIT_CUSTOM: park on user functions that set with Queue_setWaitDriver
+ */
+#define QUEUE_WAIT_NONE                 0
+#define QUEUE_WAIT_FUTEX                1
+#define QUEUE_WAIT_CUSTOM               2
+
+#ifndef QUEUE_WAIT
+    #define QUEUE_WAIT                  QUEUE_WAIT_NONE
+#endif
+/**
+ * @brief number of spin iterations before park
+ */
+#define QUEUE_WAIT_SPIN                 128
+/**
+ * @brief enable eventfd that become readable when queue goes non-empty, linux only
+ * require QUEUE_WAIT
+ */
+#ifndef QUEUE_WAIT_EVENTFD
+    #define QUEUE_WAIT_EVENTFD          0
+#endif
+/**
+ * @brief enable virtual-memory mirrored ring buffer (Queue_initMirrored), linux only
+ * same physical pages mapped twice back-to-back, so any span up to buffer size is contiguous
+ * and direct APIs return whole available/space
+ */
+#ifndef QUEUE_MIRROR
+    #define QUEUE_MIRROR                0
+#endif
+/**
+ * @brief enable statistics of queue (Queue_getStats), counters updated after each
+ * write/read operation with relaxed atomic increments
+ */
+#ifndef QUEUE_STATS
+    #define QUEUE_STATS                 0
+#endif
+/**
+ * @brief number of buckets of occupancy histogram, bucket 0 count operations that leave queue empty
+ * and bucket i count operations that leave [2^(i-1), 2^i) items in queue, last bucket hold the rest
+ */
+#define QUEUE_STATS_HISTOGRAM           16
+/**
+ * @brief type of statistics counters, 64-bit counters may need libatomic on 32-bit targets
+ */
+typedef uint32_t Queue_StatsCounter;
+/**
+ * @brief enable overwrite mode (Queue_initOverwrite), when queue is full write operations
+ * drop oldest items instead of return Queue_NoSpace
+ * write moves read position when it drop items, so writes and reads (and moveReadPos)
+ * of an overwrite queue must not run in parallel, run them in one context
+ * or hold same lock around both sides
+ */
+#ifndef QUEUE_OVERWRITE
+    #define QUEUE_OVERWRITE             0
+#endif
+/**
+ * @brief enable variable-length record mode (Queue_initRecord), records reserved and committed
+ * in place, each record has a 4-byte header and stay contiguous in buffer
+ */
+#ifndef QUEUE_RECORD
+    #define QUEUE_RECORD                0
+#endif
+/**
+ * @brief enable scatter/gather file descriptor APIs (Queue_writeFromFd, Queue_readToFd), POSIX only
+ * incomplete item of fd APIs is kept in queue between calls, it's discarded when other
+ * APIs move same position, so use fd APIs as only writer (reader) of queue to keep fd data intact
+ */
+#ifndef QUEUE_FD
+    #define QUEUE_FD                    0
+#endif
+/**
+ * @brief enable sojourn time tracking (Queue_setSojourn), each written item stamped with enqueue time
+ * in a side array parallel to buffer and reads report how long oldest item stayed in queue,
+ * optional CoDel policy (Queue_setCodel) drop oldest items on read when queueing delay stay above target
+ */
+#ifndef QUEUE_SOJOURN
+    #define QUEUE_SOJOURN               0
+#endif
+/**
+ * @brief type of timestamps, unsigned, wrap around is fine
+ */
+typedef uint32_t Queue_TimeType;
 /************************************************************************/
 
 #define __QUEUE_VER_STR(major, minor, fix)     #major "." #minor "." #fix
@@ -51,6 +151,10 @@ typedef Stream_LenType Queue_LenType;
  * @brief use for disable limit
  */
 #define QUEUE_NO_LIMIT                          STREAM_NO_LIMIT
+/**
+ * @brief use as timeout for wait forever
+ */
+#define QUEUE_WAIT_FOREVER                      0xFFFFFFFFUL
 
 #define Queue_Ok                                Stream_Ok                  /**< everything is OK */
 #define Queue_NoSpace                           Stream_NoSpace             /**< there is no space for write operation */
@@ -68,6 +172,42 @@ typedef Stream_LenType Queue_LenType;
 #define Queue_CustomError                       Stream_CustomError         /**< can be used for custom errors */
 
 typedef Stream_Result Queue_Result;
+
+#if QUEUE_STATS
+/**
+ * @brief statistics of queue, all counts are in items
+ */
+typedef struct {
+    Queue_StatsCounter      Written;                    /**< number of items written */
+    Queue_StatsCounter      Read;                       /**< number of items read */
+    Queue_StatsCounter      NoSpace;                    /**< number of write operations that failed with Queue_NoSpace */
+    Queue_StatsCounter      NoAvailable;                /**< number of read operations that failed with Queue_NoAvailable */
+    Queue_StatsCounter      WriteLimitHits;             /**< number of Queue_NoSpace that caused by write limit */
+    Queue_StatsCounter      ReadLimitHits;              /**< number of Queue_NoAvailable that caused by read limit */
+    Queue_StatsCounter      HighWatermark;              /**< maximum number of items that was in queue */
+    Queue_StatsCounter      Histogram[QUEUE_STATS_HISTOGRAM]; /**< log2 histogram of items in queue after each operation */
+} Queue_Stats;
+#endif
+#if QUEUE_SOJOURN
+/**
+ * @brief monotonic clock for sojourn time, unit is up to user (us, ticks, ...)
+ */
+typedef Queue_TimeType (*Queue_ClockFn)(void);
+/**
+ * @brief state of CoDel policy
+ */
+typedef struct {
+    Queue_TimeType          Target;                     /**< acceptable sojourn time, 0 means disabled */
+    Queue_TimeType          Interval;                   /**< sojourn must stay above target this long before first drop */
+    Queue_TimeType          FirstAbove;                 /**< time that interval above target finish */
+    Queue_TimeType          DropNext;                   /**< time of next drop in dropping state */
+    uint32_t                Count;                      /**< drops since dropping state started */
+    uint32_t                LastCount;                  /**< Count of previous dropping state */
+    uint32_t                Dropped;                    /**< number of items dropped by policy */
+    uint8_t                 Above;                      /**< sojourn is above target, FirstAbove is valid */
+    uint8_t                 Dropping;                   /**< in dropping state */
+} Queue_Codel;
+#endif
 /**
  * @brief Queue struct
  * contains everything need for handle queue
@@ -75,6 +215,42 @@ typedef Stream_Result Queue_Result;
 typedef struct {
     StreamBuffer            Buffer;                     /**< Queue buffer */
     Queue_LenType           ItemSize;                 /**< length of each item */
+#if QUEUE_WAIT
+    uint32_t                ReadSeq;                    /**< readers park on it, changed when items written and readers waiting */
+    uint32_t                WriteSeq;                   /**< writers park on it, changed when items read and writers waiting */
+    uint32_t                ReadWaiters;                /**< number of parked readers */
+    uint32_t                WriteWaiters;               /**< number of parked writers */
+#if QUEUE_WAIT_EVENTFD
+    int                     EventFd;                    /**< eventfd for notify non-empty, -1 if not opened */
+    uint32_t                EventArmed;                 /**< consumer wait for eventfd */
+#endif
+#endif
+#if QUEUE_MIRROR
+    uint8_t                 Mirrored;                   /**< buffer mapped twice back-to-back */
+#endif
+#if QUEUE_STATS
+    Queue_Stats             Stats;                      /**< statistics of queue */
+#endif
+#if QUEUE_OVERWRITE
+    uint32_t                Dropped;                    /**< number of items dropped by overwrite */
+    uint32_t                OverwriteSeq;               /**< increased before oldest items overwritten */
+    uint8_t                 Overwrite;                  /**< drop oldest items when queue is full */
+#endif
+#if QUEUE_RECORD
+    Queue_LenType           Reserved;                   /**< bytes reserved after write position that not published yet */
+#endif
+#if QUEUE_FD
+    Queue_LenType           FdWritePartial;             /**< bytes of incomplete item received after write position */
+    Queue_LenType           FdReadPartial;              /**< bytes of first item that already sent from read position */
+    Queue_LenType           FdWritePos;                 /**< write position that FdWritePartial belong to */
+    Queue_LenType           FdReadPos;                  /**< read position that FdReadPartial belong to */
+#endif
+#if QUEUE_SOJOURN
+    Queue_TimeType*         Stamps;                     /**< enqueue time of each item, parallel to buffer, NULL means disabled */
+    Queue_ClockFn           Clock;                      /**< clock of stamps */
+    Queue_TimeType          LastSojourn;                /**< sojourn time of oldest item of last read */
+    Queue_Codel             Codel;                      /**< CoDel policy state */
+#endif
 } Queue;
 /**
  * @brief Write or Read queue with custom functions as query
@@ -85,11 +261,32 @@ typedef struct {
  * @return Queue_Result
  */
 typedef Queue_Result (*Queue_QueryFn)(Queue* queue, void* val, Queue_LenType index, Queue_LenType len);
+/**
+ * @brief Write or Read queue with custom functions as batch query,
+ * called at most two times with contiguous span of items, before and after wrap around
+ * @param queue pointer to queue
+ * @param val pointer to first item of span
+ * @param index index of first item of span
+ * @param count number of items in span
+ * @param len total number of items
+ * @return Queue_Result
+ */
+typedef Queue_Result (*Queue_BatchQueryFn)(Queue* queue, void* val, Queue_LenType index, Queue_LenType count, Queue_LenType len);
 
 // -------------------------- General APIs ----------------------------
 void                Queue_init(Queue* queue, void* buffer, Queue_LenType size, Queue_LenType itemSize);
 void                Queue_fromBuff(Queue* queue, void* buffer, Queue_LenType size, Queue_LenType itemSize, Queue_LenType len);
 void                Queue_deinit(Queue* queue);
+#if QUEUE_MIRROR
+Queue_Result        Queue_initMirrored(Queue* queue, Queue_LenType capacity, Queue_LenType itemSize);
+void                Queue_deinitMirrored(Queue* queue);
+#endif
+#if QUEUE_OVERWRITE
+void                Queue_initOverwrite(Queue* queue, void* buffer, Queue_LenType size, Queue_LenType itemSize);
+#endif
+#if QUEUE_RECORD
+void                Queue_initRecord(Queue* queue, void* buffer, Queue_LenType size);
+#endif
 
 #define             Queue_space(QUEUE)                                      (Queue_spaceRaw(QUEUE) / ((QUEUE)->ItemSize))
 #define             Queue_available(QUEUE)                                  (Queue_availableRaw(QUEUE) / ((QUEUE)->ItemSize))
@@ -118,8 +315,8 @@ void                Queue_deinit(Queue* queue);
 #define             Queue_getWritePos(QUEUE)                                (Queue_getWritePosRaw(QUEUE) / ((QUEUE)->ItemSize))
 #define             Queue_getReadPos(QUEUE)                                 (Queue_getReadPosRaw(QUEUE) / ((QUEUE)->ItemSize))
 
-#define             Queue_moveWritePos(QUEUE, STEPS)                        Queue_moveReadPosRaw(QUEUE, STEPS * ((QUEUE)->ItemSize))
-#define             Queue_moveReadPos(QUEUE, STEPS)                         Queue_moveWritePosRaw(QUEUE, STEPS * ((QUEUE)->ItemSize))
+#define             Queue_moveWritePos(QUEUE, STEPS)                        Queue_moveWritePosRaw(QUEUE, (STEPS) * ((QUEUE)->ItemSize))
+#define             Queue_moveReadPos(QUEUE, STEPS)                         Queue_moveReadPosRaw(QUEUE, (STEPS) * ((QUEUE)->ItemSize))
 
 #define             Queue_flipWrite(QUEUE, LEN)                             Queue_flipWriteRaw(QUEUE, (LEN) * ((QUEUE)->ItemSize))
 #define             Queue_flipRead(QUEUE, LEN)                              Queue_flipReadRaw(QUEUE, (LEN) * ((QUEUE)->ItemSize))
@@ -129,11 +326,19 @@ void                Queue_deinit(Queue* queue);
 #define             Queue_spaceRaw(QUEUE)                                   Stream_space(&((QUEUE)->Buffer))
 #define             Queue_availableRaw(QUEUE)                               Stream_available(&((QUEUE)->Buffer))
 
-#define             Queue_directAvailableRaw(QUEUE)                         Stream_directAvailable(&((QUEUE)->Buffer))
-#define             Queue_directSpaceRaw(QUEUE)                             Stream_directSpace(&((QUEUE)->Buffer))
+#if QUEUE_MIRROR
+    #define         Queue_directAvailableRaw(QUEUE)                         ((QUEUE)->Mirrored ? Queue_availableRaw(QUEUE) : Stream_directAvailable(&((QUEUE)->Buffer)))
+    #define         Queue_directSpaceRaw(QUEUE)                             ((QUEUE)->Mirrored ? Queue_spaceRaw(QUEUE) : Stream_directSpace(&((QUEUE)->Buffer)))
 
-#define             Queue_directAvailableAtRaw(QUEUE, IDX)                  Stream_directAvailableAt(&((QUEUE)->Buffer), (IDX))
-#define             Queue_directSpaceAtRaw(QUEUE, IDX)                      Stream_directSpaceAt(&((QUEUE)->Buffer), (IDX))
+    #define         Queue_directAvailableAtRaw(QUEUE, IDX)                  ((QUEUE)->Mirrored ? (Queue_availableRaw(QUEUE) > (IDX) ? Queue_availableRaw(QUEUE) - (IDX) : 0) : Stream_directAvailableAt(&((QUEUE)->Buffer), (IDX)))
+    #define         Queue_directSpaceAtRaw(QUEUE, IDX)                      ((QUEUE)->Mirrored ? (Queue_spaceRaw(QUEUE) > (IDX) ? Queue_spaceRaw(QUEUE) - (IDX) : 0) : Stream_directSpaceAt(&((QUEUE)->Buffer), (IDX)))
+#else
+    #define         Queue_directAvailableRaw(QUEUE)                         Stream_directAvailable(&((QUEUE)->Buffer))
+    #define         Queue_directSpaceRaw(QUEUE)                             Stream_directSpace(&((QUEUE)->Buffer))
+
+    #define         Queue_directAvailableAtRaw(QUEUE, IDX)                  Stream_directAvailableAt(&((QUEUE)->Buffer), (IDX))
+    #define         Queue_directSpaceAtRaw(QUEUE, IDX)                      Stream_directSpaceAt(&((QUEUE)->Buffer), (IDX))
+#endif
 
 #define             Queue_getWritePosRaw(QUEUE)                             Stream_getWritePos(&((QUEUE)->Buffer))
 #define             Queue_getReadPosRaw(QUEUE)                              Stream_getReadPos(&((QUEUE)->Buffer))
@@ -213,27 +418,164 @@ void                Queue_deinit(Queue* queue);
     #define         Queue_mutexDeInit(STREAM)                               Stream_mutexDeInit(&(STREAM)->Buffer)
 #endif
 
+// -------------------------- Hooks ----------------------------
+/**
+ * @brief called after every write/read operation with result and number of items
+ * used for wake up waiters and update statistics, evaluate to RES when nothing need it
+ */
+#define             QUEUE_HOOKS                                             (QUEUE_WAIT || QUEUE_STATS)
+
+#if QUEUE_HOOKS
+    #define         __Queue_writeHook(QUEUE, RES, LEN)                      __Queue_onWrite((QUEUE), (RES), (LEN))
+    #define         __Queue_readHook(QUEUE, RES, LEN)                       __Queue_onRead((QUEUE), (RES), (LEN))
+
+Queue_Result        __Queue_onWrite(Queue* queue, Queue_Result res, Queue_LenType len);
+Queue_Result        __Queue_onRead(Queue* queue, Queue_Result res, Queue_LenType len);
+#else
+    #define         __Queue_writeHook(QUEUE, RES, LEN)                      (RES)
+    #define         __Queue_readHook(QUEUE, RES, LEN)                       (RES)
+#endif
+/**
+ * @brief called before every write/read operation with number of items
+ * used for make room in overwrite mode and sojourn stamps, evaluate to OP when nothing need it
+ */
+#define             QUEUE_PRE_HOOKS                                         (QUEUE_OVERWRITE || QUEUE_SOJOURN)
+
+#if QUEUE_PRE_HOOKS
+    #define         __Queue_preWrite(QUEUE, LEN)                            __Queue_onPreWrite((QUEUE), (LEN))
+
+void                __Queue_onPreWrite(Queue* queue, Queue_LenType len);
+#else
+    #define         __Queue_preWrite(QUEUE, LEN)                            ((void) 0)
+#endif
+#if QUEUE_SOJOURN
+    #define         __Queue_preRead(QUEUE, LEN)                             __Queue_onPreRead((QUEUE), (LEN))
+
+void                __Queue_onPreRead(Queue* queue, Queue_LenType len);
+#else
+    #define         __Queue_preRead(QUEUE, LEN)                             ((void) 0)
+#endif
+#define             __Queue_preWriteHook(QUEUE, LEN, OP)                    (__Queue_preWrite(QUEUE, LEN), (OP))
+#define             __Queue_preReadHook(QUEUE, LEN, OP)                     (__Queue_preRead(QUEUE, LEN), (OP))
+
 /**************** Write APIs **************/
-#define             Queue_write(QUEUE, VAL)                                 Stream_writeBytes(&(QUEUE)->Buffer, (uint8_t*) (VAL), (QUEUE)->ItemSize)
+#define             Queue_write(QUEUE, VAL)                                 __Queue_writeHook(QUEUE, __Queue_preWriteHook(QUEUE, 1, Stream_writeBytes(&(QUEUE)->Buffer, (uint8_t*) (VAL), (QUEUE)->ItemSize)), 1)
 #if STREAM_WRITE_ARRAY
-    #define         Queue_writeArray(QUEUE, VAL, LEN)                       Stream_writeBytes(&(QUEUE)->Buffer, (uint8_t*) (VAL), (LEN) * (QUEUE)->ItemSize)
+    #define         Queue_writeArray(QUEUE, VAL, LEN)                       __Queue_writeHook(QUEUE, __Queue_preWriteHook(QUEUE, (LEN), Stream_writeBytes(&(QUEUE)->Buffer, (uint8_t*) (VAL), (LEN) * (QUEUE)->ItemSize)), (LEN))
 #endif // STREAM_WRITE_ARRAY
 #if STREAM_WRITE_STREAM
-    #define         Queue_writeQueue(OUT, IN, LEN)                          Stream_writeStream(&(OUT)->Buffer, &(IN)->Buffer, (LEN) * (OUT)->ItemSize)
+    #define         Queue_writeQueue(OUT, IN, LEN)                          __Queue_readHook(IN, __Queue_writeHook(OUT, __Queue_preReadHook(IN, (LEN), __Queue_preWriteHook(OUT, (LEN), Stream_writeStream(&(OUT)->Buffer, &(IN)->Buffer, (LEN) * (OUT)->ItemSize))), (LEN)), (LEN))
 #endif // STREAM_WRITE_STREAM
 Queue_Result        Queue_writeQuery(Queue* queue, Queue_QueryFn query);
 Queue_Result        Queue_writeQueryArray(Queue* queue, Queue_LenType len, Queue_QueryFn query);
+Queue_Result        Queue_writeQueryBatch(Queue* queue, Queue_LenType len, Queue_BatchQueryFn query);
 
 /**************** Read APIs **************/
-#define             Queue_read(QUEUE, VAL)                                  Stream_readBytes(&(QUEUE)->Buffer, (uint8_t*) (VAL), (QUEUE)->ItemSize)
+#define             Queue_read(QUEUE, VAL)                                  __Queue_readHook(QUEUE, __Queue_preReadHook(QUEUE, 1, Stream_readBytes(&(QUEUE)->Buffer, (uint8_t*) (VAL), (QUEUE)->ItemSize)), 1)
 #if STREAM_READ_ARRAY
-    #define         Queue_readArray(QUEUE, VAL, LEN)                        Stream_readBytes(&(QUEUE)->Buffer, (uint8_t*) (VAL), (LEN) * (QUEUE)->ItemSize)
+    #define         Queue_readArray(QUEUE, VAL, LEN)                        __Queue_readHook(QUEUE, __Queue_preReadHook(QUEUE, (LEN), Stream_readBytes(&(QUEUE)->Buffer, (uint8_t*) (VAL), (LEN) * (QUEUE)->ItemSize)), (LEN))
 #endif // STREAM_READ_ARRAY
 #if STREAM_READ_STREAM
-    #define         Queue_readQueue(IN, OUT, LEN)                           Stream_readStream(&(IN)->Buffer, &(OUT)->Buffer, (LEN) * (IN)->ItemSize)
+    #define         Queue_readQueue(IN, OUT, LEN)                           __Queue_writeHook(OUT, __Queue_readHook(IN, __Queue_preReadHook(IN, (LEN), __Queue_preWriteHook(OUT, (LEN), Stream_readStream(&(IN)->Buffer, &(OUT)->Buffer, (LEN) * (IN)->ItemSize))), (LEN)), (LEN))
 #endif // STREAM_READ_STREAM
 Queue_Result        Queue_readQuery(Queue* queue, Queue_QueryFn query);
 Queue_Result        Queue_readQueryArray(Queue* queue, Queue_LenType len, Queue_QueryFn query);
+Queue_Result        Queue_readQueryBatch(Queue* queue, Queue_LenType len, Queue_BatchQueryFn query);
+
+// -------------------------- Stats APIs ----------------------------
+#if QUEUE_STATS
+void                Queue_getStats(Queue* queue, Queue_Stats* stats);
+void                Queue_resetStats(Queue* queue);
+#endif // QUEUE_STATS
+
+// -------------------------- Overwrite APIs ----------------------------
+#if QUEUE_OVERWRITE
+    #define         Queue_isOverwrite(QUEUE)                                ((QUEUE)->Overwrite)
+
+uint32_t            Queue_getDropped(Queue* queue);
+uint32_t            Queue_overwriteMark(Queue* queue);
+uint8_t             Queue_wasOverwritten(Queue* queue, uint32_t mark);
+#endif // QUEUE_OVERWRITE
+
+// -------------------------- Record APIs ----------------------------
+#if QUEUE_RECORD
+/**
+ * @brief size of record header, header is uint32_t: bit 31 committed, bit 30 padding, bits 0-29 length
+ */
+#define             QUEUE_RECORD_HEADER                                     4
+/**
+ * @brief records start at multiple of this value, buffer must be aligned to it too
+ */
+#define             QUEUE_RECORD_ALIGN                                      4
+/**
+ * @brief maximum length of a record in bytes
+ */
+#define             QUEUE_RECORD_MAX_LEN                                    0x3FFFFFFFUL
+
+void*               Queue_reserve(Queue* queue, Queue_LenType len);
+Queue_Result        Queue_commit(Queue* queue, void* ptr);
+
+void*               Queue_peekRecord(Queue* queue, Queue_LenType* len);
+Queue_Result        Queue_release(Queue* queue);
+#endif // QUEUE_RECORD
+
+// -------------------------- FD APIs ----------------------------
+#if QUEUE_FD
+/**
+ * @brief return value of Queue_writeFromFd when fd reach end of file
+ */
+#define             QUEUE_FD_EOF                                            (-2)
+
+Queue_LenType       Queue_writeFromFd(Queue* queue, int fd, Queue_LenType maxItems);
+Queue_LenType       Queue_readToFd(Queue* queue, int fd, Queue_LenType maxItems);
+#endif // QUEUE_FD
+
+// -------------------------- Sojourn APIs ----------------------------
+#if QUEUE_SOJOURN
+    #define         Queue_getSojourn(QUEUE)                                 ((QUEUE)->LastSojourn)
+    #define         Queue_isCodelDropping(QUEUE)                            ((QUEUE)->Codel.Dropping)
+
+Queue_Result        Queue_setSojourn(Queue* queue, Queue_TimeType* stamps, Queue_ClockFn clock);
+void                Queue_setCodel(Queue* queue, Queue_TimeType target, Queue_TimeType interval);
+Queue_TimeType      Queue_headSojourn(Queue* queue);
+uint32_t            Queue_getCodelDropped(Queue* queue);
+#endif // QUEUE_SOJOURN
+
+// -------------------------- Wait APIs ----------------------------
+#if QUEUE_WAIT
+#if QUEUE_WAIT == QUEUE_WAIT_CUSTOM
+/**
+ * @brief park and wake functions for QUEUE_WAIT_CUSTOM
+ */
+typedef struct {
+    /**
+     * @brief block while *addr == expected, at most timeout ms, can return spuriously
+     */
+    void        (*wait)(uint32_t* addr, uint32_t expected, uint32_t timeout);
+    /**
+     * @brief wake up all threads that wait on addr
+     */
+    void        (*wake)(uint32_t* addr);
+    /**
+     * @brief return monotonic time in ms
+     */
+    uint32_t    (*getTick)(void);
+} Queue_WaitDriver;
+
+void                Queue_setWaitDriver(const Queue_WaitDriver* driver);
+#endif
+
+#define             Queue_writeWait(QUEUE, VAL, TIMEOUT)                    Queue_writeArrayWait((QUEUE), (VAL), 1, (TIMEOUT))
+Queue_Result        Queue_writeArrayWait(Queue* queue, const void* val, Queue_LenType len, uint32_t timeout);
+#define             Queue_readWait(QUEUE, VAL, TIMEOUT)                     Queue_readArrayWait((QUEUE), (VAL), 1, (TIMEOUT))
+Queue_Result        Queue_readArrayWait(Queue* queue, void* val, Queue_LenType len, uint32_t timeout);
+
+#if QUEUE_WAIT_EVENTFD
+int                 Queue_openEventFd(Queue* queue);
+void                Queue_closeEventFd(Queue* queue);
+Queue_LenType       Queue_armEventFd(Queue* queue);
+#endif
+#endif // QUEUE_WAIT
 
 #if STREAM_GET_AT
     #define         Queue_getAt(QUEUE, IDX, VAL)                                Stream_getBytesAt(&(QUEUE)->Buffer, (IDX), (uint8_t*) (VAL), (QUEUE)->ItemSize)
@@ -255,6 +597,58 @@ Queue_Result        Queue_readQueryArray(Queue* queue, Queue_LenType len, Queue_
     #define         Queue_setArray(QUEUE, VAL, LEN)                             Stream_setBytes(&(QUEUE)->Buffer, (uint8_t*) (VAL), (LEN) * (QUEUE)->ItemSize)
 #endif // STREAM_SET
 
+// -------------------------- SPSC APIs ----------------------------
+#if QUEUE_SPSC
+/**
+ * @brief lock-free single-producer/single-consumer queue
+ * producer fields and consumer fields are placed in separate cache lines,
+ * each side keep a cached copy of other side position and only reload it
+ * when cached value is not enough, so write and read are wait-free
+ * positions are in range [0, 2 * Size) so full and empty states are distinguishable,
+ * 2 * Size must fit in Queue_LenType
+ */
+typedef struct {
+    Queue_LenType           WPos;                       /**< write position, owned by producer */
+    Queue_LenType           RPosCache;                  /**< last read position that producer seen */
+    uint8_t                 __padWrite[QUEUE_CACHE_LINE_SIZE - 2 * sizeof(Queue_LenType)];
+    Queue_LenType           RPos;                       /**< read position, owned by consumer */
+    Queue_LenType           WPosCache;                  /**< last write position that consumer seen */
+    uint8_t                 __padRead[QUEUE_CACHE_LINE_SIZE - 2 * sizeof(Queue_LenType)];
+    uint8_t*                Data;                       /**< queue buffer */
+    Queue_LenType           Size;                       /**< size of buffer in bytes, multiple of ItemSize */
+    Queue_LenType           ItemSize;                   /**< length of each item */
+} QueueSPSC;
+/**
+ * @brief Write or Read SPSC queue with custom functions as query
+ * @param queue pointer to queue
+ * @param val pointer to item in queue buffer
+ * @param index index of item
+ * @param len number of items
+ * @return Queue_Result
+ */
+typedef Queue_Result (*QueueSPSC_QueryFn)(QueueSPSC* queue, void* val, Queue_LenType index, Queue_LenType len);
+
+Queue_Result        QueueSPSC_init(QueueSPSC* queue, void* buffer, Queue_LenType size, Queue_LenType itemSize);
+void                QueueSPSC_deinit(QueueSPSC* queue);
+
+Queue_LenType       QueueSPSC_available(QueueSPSC* queue);
+Queue_LenType       QueueSPSC_space(QueueSPSC* queue);
+
+#define             QueueSPSC_isEmpty(QUEUE)                                (QueueSPSC_available(QUEUE) == 0)
+#define             QueueSPSC_isFull(QUEUE)                                 (QueueSPSC_space(QUEUE) == 0)
+#define             QueueSPSC_getBufferSize(QUEUE)                          ((QUEUE)->Size / (QUEUE)->ItemSize)
+
+#define             QueueSPSC_write(QUEUE, VAL)                             QueueSPSC_writeArray((QUEUE), (VAL), 1)
+Queue_Result        QueueSPSC_writeArray(QueueSPSC* queue, const void* val, Queue_LenType len);
+#define             QueueSPSC_writeQuery(QUEUE, QUERY)                      QueueSPSC_writeQueryArray((QUEUE), 1, (QUERY))
+Queue_Result        QueueSPSC_writeQueryArray(QueueSPSC* queue, Queue_LenType len, QueueSPSC_QueryFn query);
+
+#define             QueueSPSC_read(QUEUE, VAL)                              QueueSPSC_readArray((QUEUE), (VAL), 1)
+Queue_Result        QueueSPSC_readArray(QueueSPSC* queue, void* val, Queue_LenType len);
+#define             QueueSPSC_readQuery(QUEUE, QUERY)                       QueueSPSC_readQueryArray((QUEUE), 1, (QUERY))
+Queue_Result        QueueSPSC_readQueryArray(QueueSPSC* queue, Queue_LenType len, QueueSPSC_QueryFn query);
+#endif // QUEUE_SPSC
+
 #ifdef __cplusplus
 };
 #endif
@@ -0,0 +1,290 @@
+/**
+ * @file Queue.hpp
+ * @author Ali Mirghasemi (ali.mirghasemi1376@gmail.com)
+ * @brief header-only C++ wrapper over Queue with in-place construction and move semantics
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * queue::Queue<T, N> own its storage (no heap allocation), construct items directly
+ * in ring slots and move them out on pop, so non-trivially-copyable types can be stored.
+ * Positions are kept in a normal C Queue, base() return it for use with Queue_* APIs
+ * that don't copy items (available, space, limits, ...).
+ */
+#ifndef _QUEUE_HPP_
+#define _QUEUE_HPP_
+
+#include "Queue.h"
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#if __cplusplus >= 201703L
+    #include <optional>
+#endif
+
+/**
+ * @brief exceptions are enabled, range operations clean up partially done work before rethrow
+ */
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+    #define QUEUE_HPP_EXCEPTIONS        1
+#else
+    #define QUEUE_HPP_EXCEPTIONS        0
+#endif
+
+namespace queue {
+
+template <class T, std::size_t N>
+class Queue {
+public:
+    static_assert(N > 0, "Queue capacity must be greater than zero");
+    static_assert(N * sizeof(T) <= static_cast<std::size_t>(std::numeric_limits<Queue_LenType>::max()),
+                  "Queue buffer size must fit in Queue_LenType");
+
+    typedef T                   value_type;
+    typedef T&                  reference;
+    typedef const T&            const_reference;
+    typedef std::size_t         size_type;
+
+    template <class Q, class V>
+    class Iterator {
+    public:
+        typedef std::forward_iterator_tag   iterator_category;
+        typedef V                           value_type;
+        typedef std::ptrdiff_t              difference_type;
+        typedef V*                          pointer;
+        typedef V&                          reference;
+
+        Iterator(Q* queue, size_type index) noexcept : _queue(queue), _index(index) {}
+
+        reference operator*() const noexcept { return *_queue->slot(_index); }
+        pointer operator->() const noexcept { return _queue->slot(_index); }
+        Iterator& operator++() noexcept { ++_index; return *this; }
+        Iterator operator++(int) noexcept { Iterator it = *this; ++_index; return it; }
+        bool operator==(const Iterator& other) const noexcept { return _index == other._index; }
+        bool operator!=(const Iterator& other) const noexcept { return _index != other._index; }
+
+    private:
+        Q*          _queue;
+        size_type   _index;
+    };
+
+    typedef Iterator<Queue, T>              iterator;
+    typedef Iterator<const Queue, const T>  const_iterator;
+
+    Queue() noexcept {
+        Queue_init(&_base, _storage, static_cast<Queue_LenType>(sizeof(_storage)), static_cast<Queue_LenType>(sizeof(T)));
+    }
+    ~Queue() {
+        clear();
+        Queue_deinit(&_base);
+    }
+
+    Queue(const Queue&) = delete;
+    Queue& operator=(const Queue&) = delete;
+
+    /**
+     * @brief return underlying C queue
+     */
+    ::Queue* base() noexcept { return &_base; }
+
+    static constexpr size_type capacity() noexcept { return N; }
+    size_type size() const noexcept { return static_cast<size_type>(Queue_availableRaw(&_base)) / sizeof(T); }
+    size_type space() const noexcept { return static_cast<size_type>(Queue_spaceRaw(&_base)) / sizeof(T); }
+    bool empty() const noexcept { return size() == 0; }
+    bool full() const noexcept { return space() == 0; }
+
+    /**
+     * @brief construct item in place at write slot
+     * @return false if there is no space
+     */
+    template <class... Args>
+    bool emplace(Args&&... args) {
+        if (full()) {
+            return false;
+        }
+        ::new (static_cast<void*>(writeSlot(0))) T(std::forward<Args>(args)...);
+        commitWrite(1);
+        return true;
+    }
+    bool push(const T& val) { return emplace(val); }
+    bool push(T&& val) { return emplace(std::move(val)); }
+    /**
+     * @brief push items in range until queue is full, copies are staged in free slots
+     * and write position is committed once, if iterator or copy throw staged copies are
+     * destroyed and queue is unchanged
+     * @return number of items pushed
+     */
+    template <class InputIt>
+    size_type push_range(InputIt first, InputIt last) {
+        size_type count = 0;
+        size_type free = space();
+    #if QUEUE_HPP_EXCEPTIONS
+        try {
+    #endif
+            while (first != last && count < free) {
+                ::new (static_cast<void*>(writeSlot(count))) T(*first);
+                ++first;
+                ++count;
+            }
+    #if QUEUE_HPP_EXCEPTIONS
+        }
+        catch (...) {
+            while (count > 0) {
+                --count;
+                writeSlot(count)->~T();
+            }
+            throw;
+        }
+    #endif
+        if (count > 0) {
+            commitWrite(count);
+        }
+        return count;
+    }
+
+    reference front() noexcept { return *slot(0); }
+    const_reference front() const noexcept { return *slot(0); }
+    /**
+     * @brief destroy first item
+     * @return false if queue is empty
+     */
+    bool pop() noexcept {
+        if (empty()) {
+            return false;
+        }
+        slot(0)->~T();
+        commitRead(1);
+        return true;
+    }
+    /**
+     * @brief move first item into out and remove it
+     * @return false if queue is empty
+     */
+    bool pop(T& out) {
+        if (empty()) {
+            return false;
+        }
+        T* item = slot(0);
+        out = std::move(*item);
+        item->~T();
+        commitRead(1);
+        return true;
+    }
+#if __cplusplus >= 201703L
+    /**
+     * @brief remove first item and return it, or std::nullopt if queue is empty
+     */
+    std::optional<T> try_pop() {
+        if (empty()) {
+            return std::nullopt;
+        }
+        T* item = slot(0);
+        std::optional<T> out(std::move(*item));
+        item->~T();
+        commitRead(1);
+        return out;
+    }
+#else
+    bool try_pop(T& out) { return pop(out); }
+#endif
+    /**
+     * @brief move up to maxLen items into output iterator, if output throw
+     * items that already moved out are removed and rest stay in queue
+     * @return number of items popped
+     */
+    template <class OutputIt>
+    size_type pop_range(OutputIt out, size_type maxLen) {
+        size_type count = size();
+        size_type i = 0;
+        if (count > maxLen) {
+            count = maxLen;
+        }
+    #if QUEUE_HPP_EXCEPTIONS
+        try {
+    #endif
+            for (; i < count; i++) {
+                T* item = slot(i);
+                *out = std::move(*item);
+                ++out;
+                item->~T();
+            }
+    #if QUEUE_HPP_EXCEPTIONS
+        }
+        catch (...) {
+            if (i > 0) {
+                commitRead(i);
+            }
+            throw;
+        }
+    #endif
+        if (count > 0) {
+            commitRead(count);
+        }
+        return count;
+    }
+    /**
+     * @brief destroy all items
+     */
+    void clear() noexcept {
+        size_type count = size();
+        size_type i;
+        for (i = 0; i < count; i++) {
+            slot(i)->~T();
+        }
+        Queue_reset(&_base);
+    }
+
+    iterator begin() noexcept { return iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, size()); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size()); }
+
+private:
+    T* slot(size_type index) const noexcept {
+        size_type pos = static_cast<size_type>(Queue_getReadPosRaw(&_base)) / sizeof(T) + index;
+        if (pos >= N) {
+            pos -= N;
+        }
+        return reinterpret_cast<T*>(const_cast<unsigned char*>(_storage)) + pos;
+    }
+    T* writeSlot(size_type index) const noexcept {
+        size_type pos = static_cast<size_type>(Queue_getWritePosRaw(&_base)) / sizeof(T) + index;
+        if (pos >= N) {
+            pos -= N;
+        }
+        return reinterpret_cast<T*>(const_cast<unsigned char*>(_storage)) + pos;
+    }
+    void commitWrite(size_type count) noexcept {
+        Queue_LenType len = static_cast<Queue_LenType>(count * sizeof(T));
+    #if STREAM_WRITE_LIMIT
+        if (Queue_isWriteLimited(&_base)) {
+            _base.Buffer.WriteLimit -= len;
+        }
+    #endif
+        (void) __Queue_writeHook(&_base, Queue_moveWritePosRaw(&_base, len), static_cast<Queue_LenType>(count));
+    }
+    void commitRead(size_type count) noexcept {
+        Queue_LenType len = static_cast<Queue_LenType>(count * sizeof(T));
+    #if STREAM_READ_LIMIT
+        if (Queue_isReadLimited(&_base)) {
+            _base.Buffer.ReadLimit -= len;
+        }
+    #endif
+        (void) __Queue_readHook(&_base, Queue_moveReadPosRaw(&_base, len), static_cast<Queue_LenType>(count));
+    }
+
+    friend class Iterator<Queue, T>;
+    friend class Iterator<const Queue, const T>;
+
+    alignas(T) unsigned char    _storage[N * sizeof(T)];
+    mutable ::Queue             _base;
+};
+
+} // namespace queue
+
+#endif /* _QUEUE_HPP_ */
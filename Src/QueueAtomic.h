@@ -0,0 +1,56 @@
+/**
+ * @file QueueAtomic.h
+ * @author Ali Mirghasemi (ali.mirghasemi1376@gmail.com)
+ * @brief thin wrappers over compiler atomic builtins, used by lock-free queue variants
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#ifndef _QUEUE_ATOMIC_H_
+#define _QUEUE_ATOMIC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if !defined(__GNUC__) && !defined(__clang__)
+    #error "Queue atomic helpers require GCC or Clang __atomic builtins"
+#endif
+
+#define QUEUE_RELAXED                               __ATOMIC_RELAXED
+#define QUEUE_ACQUIRE                               __ATOMIC_ACQUIRE
+#define QUEUE_RELEASE                               __ATOMIC_RELEASE
+#define QUEUE_ACQ_REL                               __ATOMIC_ACQ_REL
+#define QUEUE_SEQ_CST                               __ATOMIC_SEQ_CST
+
+#define Queue_atomicLoad(PTR, ORDER)                __atomic_load_n((PTR), (ORDER))
+#define Queue_atomicStore(PTR, VAL, ORDER)          __atomic_store_n((PTR), (VAL), (ORDER))
+#define Queue_atomicAdd(PTR, VAL, ORDER)            __atomic_fetch_add((PTR), (VAL), (ORDER))
+#define Queue_atomicSub(PTR, VAL, ORDER)            __atomic_fetch_sub((PTR), (VAL), (ORDER))
+#define Queue_atomicExchange(PTR, VAL, ORDER)       __atomic_exchange_n((PTR), (VAL), (ORDER))
+#define Queue_atomicOr(PTR, VAL, ORDER)             __atomic_fetch_or((PTR), (VAL), (ORDER))
+#define Queue_atomicAnd(PTR, VAL, ORDER)            __atomic_fetch_and((PTR), (VAL), (ORDER))
+/**
+ * @brief weak compare and swap, EXP is pointer to expected value and updated on failure
+ */
+#define Queue_atomicCas(PTR, EXP, DES, SUCC, FAIL)  __atomic_compare_exchange_n((PTR), (EXP), (DES), 1, (SUCC), (FAIL))
+#define Queue_atomicFence(ORDER)                    __atomic_thread_fence(ORDER)
+
+/**
+ * @brief hint cpu that we are in a spin loop
+ */
+#if defined(__x86_64__) || defined(__i386__)
+    #define Queue_cpuRelax()                        __builtin_ia32_pause()
+#elif defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+    #define Queue_cpuRelax()                        __asm__ __volatile__("yield" ::: "memory")
+#else
+    #define Queue_cpuRelax()                        __asm__ __volatile__("" ::: "memory")
+#endif
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _QUEUE_ATOMIC_H_ */
@@ -0,0 +1,394 @@
+#include "QueueBroadcast.h"
+
+#if QUEUE_BROADCAST && QUEUE
+
+#include "QueueAtomic.h"
+#include <string.h>
+
+#define __QueueBroadcast_ptr(QUEUE, POS)            ((QUEUE)->Data + ((POS) & (QUEUE)->Mask) * (QUEUE)->ItemSize)
+#define __QueueBroadcast_capacity(QUEUE)            ((QUEUE)->Mask + 1)
+/**
+ * @brief reader slot claimed but position not ready yet, ignored by writer
+ */
+#define __QueueBroadcast_ReaderAdding               3
+
+/**
+ * @brief copy items between user buffer and ring, split at end of buffer
+ *
+ * @param queue
+ * @param pos position of first item
+ * @param val user buffer
+ * @param len number of items
+ * @param write 1 for copy into ring
+ */
+static void __QueueBroadcast_copy(QueueBroadcast* queue, QueueBroadcast_PosType pos, uint8_t* val, Queue_LenType len, uint8_t write) {
+    QueueBroadcast_PosType index = pos & queue->Mask;
+    Queue_LenType first = (Queue_LenType) (__QueueBroadcast_capacity(queue) - index);
+    uint8_t* ptr = queue->Data + index * queue->ItemSize;
+
+    if (first > len) {
+        first = len;
+    }
+    if (write) {
+        memcpy(ptr, val, first * queue->ItemSize);
+        memcpy(queue->Data, val + first * queue->ItemSize, (len - first) * queue->ItemSize);
+    }
+    else {
+        memcpy(val, ptr, first * queue->ItemSize);
+        memcpy(val + first * queue->ItemSize, queue->Data, (len - first) * queue->ItemSize);
+    }
+}
+/**
+ * @brief find slowest active reader, readers that block write of len items
+ * are detached or skipped based on lag policy
+ *
+ * @param queue
+ * @param wpos write position
+ * @param len number of items that writer need
+ * @return QueueBroadcast_PosType position of slowest reader, wpos if there is no reader
+ */
+static QueueBroadcast_PosType __QueueBroadcast_minPos(QueueBroadcast* queue, QueueBroadcast_PosType wpos, Queue_LenType len) {
+    QueueBroadcast_PosType cap = __QueueBroadcast_capacity(queue);
+    QueueBroadcast_PosType min = wpos;
+    QueueBroadcast_PosType pos;
+    QueueBroadcast_Reader* reader;
+    uint32_t state;
+    uint8_t i;
+
+    for (i = 0; i < QUEUE_BROADCAST_MAX_READERS; i++) {
+        reader = &queue->Readers[i];
+        if (Queue_atomicLoad(&reader->State, QUEUE_ACQUIRE) != QueueBroadcast_ReaderActive) {
+            continue;
+        }
+        pos = Queue_atomicLoad(&reader->Pos, QUEUE_ACQUIRE);
+        if (wpos + (QueueBroadcast_PosType) len - pos > cap) {
+            switch (queue->LagPolicy) {
+                case QueueBroadcast_LagDetach:
+                    state = QueueBroadcast_ReaderActive;
+                    if (Queue_atomicCas(&reader->State, &state, QueueBroadcast_ReaderDetached, QUEUE_ACQ_REL, QUEUE_RELAXED)) {
+                        continue;
+                    }
+                    break;
+                case QueueBroadcast_LagSkip:
+                    // reader may move forward at same time, CAS fail reload pos
+                    while (wpos + (QueueBroadcast_PosType) len - pos > cap &&
+                           !Queue_atomicCas(&reader->Pos, &pos, wpos + (QueueBroadcast_PosType) len - cap, QUEUE_ACQ_REL, QUEUE_ACQUIRE)
+                    ) {
+                        // pos reloaded by failed cas
+                    }
+                    if (wpos + (QueueBroadcast_PosType) len - pos > cap) {
+                        Queue_atomicAdd(&reader->Skipped, (uint32_t) (wpos + (QueueBroadcast_PosType) len - cap - pos), QUEUE_RELAXED);
+                        pos = wpos + (QueueBroadcast_PosType) len - cap;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        if ((QueueBroadcast_PosType) (wpos - pos) > (QueueBroadcast_PosType) (wpos - min)) {
+            min = pos;
+        }
+    }
+    // detached and skipped readers must see new state before their items overwritten
+    Queue_atomicFence(QUEUE_RELEASE);
+
+    return min;
+}
+/**
+ * @brief initialize broadcast queue
+ * number of items is rounded down to power of 2
+ *
+ * @param queue address of queue struct
+ * @param buffer address of byte buffer
+ * @param size size of buffer
+ * @param itemSize size of each item
+ * @param policy what to do with readers that lag behind
+ * @return Queue_Result Queue_NoSpace if buffer can't hold one item, queue has zero capacity
+ */
+Queue_Result QueueBroadcast_init(QueueBroadcast* queue, void* buffer, Queue_LenType size, Queue_LenType itemSize, QueueBroadcast_LagPolicy policy) {
+    QueueBroadcast_PosType items = 1;
+    uint8_t i;
+
+    if (buffer == NULL || itemSize <= 0 || size < itemSize) {
+        QueueBroadcast_deinit(queue);
+        queue->LagPolicy = (uint8_t) policy;
+        return Queue_NoSpace;
+    }
+    // round down number of items to power of 2
+    while ((Queue_LenType) (items << 1) * itemSize <= size) {
+        items <<= 1;
+    }
+    queue->Data = (uint8_t*) buffer;
+    queue->Mask = items - 1;
+    queue->ItemSize = itemSize;
+    queue->LagPolicy = (uint8_t) policy;
+    queue->WPos = 0;
+    queue->MinPos = 0;
+    for (i = 0; i < QUEUE_BROADCAST_MAX_READERS; i++) {
+        queue->Readers[i].Pos = 0;
+        queue->Readers[i].Skipped = 0;
+        queue->Readers[i].State = QueueBroadcast_ReaderFree;
+    }
+    Queue_atomicFence(QUEUE_SEQ_CST);
+    return Queue_Ok;
+}
+/**
+ * @brief de-initialize broadcast queue
+ *
+ * @param queue
+ */
+void QueueBroadcast_deinit(QueueBroadcast* queue) {
+    uint8_t i;
+
+    queue->Data = NULL;
+    // capacity is Mask + 1, so it's zero capacity
+    queue->Mask = (QueueBroadcast_PosType) -1;
+    queue->ItemSize = 0;
+    queue->WPos = 0;
+    queue->MinPos = 0;
+    for (i = 0; i < QUEUE_BROADCAST_MAX_READERS; i++) {
+        queue->Readers[i].Pos = 0;
+        queue->Readers[i].Skipped = 0;
+        queue->Readers[i].State = QueueBroadcast_ReaderFree;
+    }
+}
+/**
+ * @brief register new reader, reader start from next written item
+ *
+ * @param queue
+ * @return Queue_LenType reader index, -1 if all readers are in use
+ */
+Queue_LenType QueueBroadcast_addReader(QueueBroadcast* queue) {
+    QueueBroadcast_Reader* reader;
+    uint32_t state;
+    uint8_t i;
+
+    for (i = 0; i < QUEUE_BROADCAST_MAX_READERS; i++) {
+        reader = &queue->Readers[i];
+        state = QueueBroadcast_ReaderFree;
+        if (Queue_atomicCas(&reader->State, &state, __QueueBroadcast_ReaderAdding, QUEUE_ACQUIRE, QUEUE_RELAXED)) {
+            reader->Skipped = 0;
+            Queue_atomicStore(&reader->Pos, Queue_atomicLoad(&queue->WPos, QUEUE_ACQUIRE), QUEUE_RELAXED);
+            Queue_atomicStore(&reader->State, QueueBroadcast_ReaderActive, QUEUE_SEQ_CST);
+            // writer that missed new reader only overwrite items before this position
+            Queue_atomicStore(&reader->Pos, Queue_atomicLoad(&queue->WPos, QUEUE_SEQ_CST), QUEUE_RELEASE);
+            return (Queue_LenType) i;
+        }
+    }
+
+    return -1;
+}
+/**
+ * @brief remove reader, also required for reuse detached readers
+ *
+ * @param queue
+ * @param reader reader index
+ */
+void QueueBroadcast_removeReader(QueueBroadcast* queue, Queue_LenType reader) {
+    Queue_atomicStore(&queue->Readers[reader].State, QueueBroadcast_ReaderFree, QUEUE_RELEASE);
+}
+/**
+ * @brief return number of free items based on slowest reader, it's a snapshot
+ * that ignore lag policy, writer side
+ *
+ * @param queue
+ * @return Queue_LenType
+ */
+Queue_LenType QueueBroadcast_space(QueueBroadcast* queue) {
+    QueueBroadcast_PosType wpos = queue->WPos;
+    QueueBroadcast_PosType min = wpos;
+    QueueBroadcast_PosType pos;
+    uint8_t i;
+
+    for (i = 0; i < QUEUE_BROADCAST_MAX_READERS; i++) {
+        if (Queue_atomicLoad(&queue->Readers[i].State, QUEUE_ACQUIRE) == QueueBroadcast_ReaderActive) {
+            pos = Queue_atomicLoad(&queue->Readers[i].Pos, QUEUE_ACQUIRE);
+            if ((QueueBroadcast_PosType) (wpos - pos) > (QueueBroadcast_PosType) (wpos - min)) {
+                min = pos;
+            }
+        }
+    }
+
+    return (Queue_LenType) (__QueueBroadcast_capacity(queue) - (wpos - min));
+}
+/**
+ * @brief write array of items for all readers, it's all or nothing
+ * slowest reader only checked when cached position is not enough
+ *
+ * @param queue
+ * @param val address of items
+ * @param len number of items
+ * @return Queue_Result
+ */
+Queue_Result QueueBroadcast_writeArray(QueueBroadcast* queue, const void* val, Queue_LenType len) {
+    QueueBroadcast_PosType cap = __QueueBroadcast_capacity(queue);
+    QueueBroadcast_PosType wpos = queue->WPos;
+
+#if STREAM_CHECK_ZERO_LEN
+    if (len == 0) {
+        return Queue_ZeroLen;
+    }
+#endif
+    if ((QueueBroadcast_PosType) len > cap) {
+        return Queue_NoSpace;
+    }
+
+    if (wpos + (QueueBroadcast_PosType) len - queue->MinPos > cap) {
+        queue->MinPos = __QueueBroadcast_minPos(queue, wpos, len);
+        if (wpos + (QueueBroadcast_PosType) len - queue->MinPos > cap) {
+            return Queue_NoSpace;
+        }
+    }
+
+    __QueueBroadcast_copy(queue, wpos, (uint8_t*) val, len, 1);
+    // publish items
+    Queue_atomicStore(&queue->WPos, wpos + (QueueBroadcast_PosType) len, QUEUE_RELEASE);
+
+    return Queue_Ok;
+}
+/**
+ * @brief return number of items that reader can read
+ *
+ * @param queue
+ * @param reader reader index
+ * @return Queue_LenType
+ */
+Queue_LenType QueueBroadcast_available(QueueBroadcast* queue, Queue_LenType reader) {
+    QueueBroadcast_PosType pos = Queue_atomicLoad(&queue->Readers[reader].Pos, QUEUE_ACQUIRE);
+    return (Queue_LenType) (Queue_atomicLoad(&queue->WPos, QUEUE_ACQUIRE) - pos);
+}
+/**
+ * @brief return number of items that reader can read without wrap around
+ *
+ * @param queue
+ * @param reader reader index
+ * @return Queue_LenType
+ */
+Queue_LenType QueueBroadcast_directAvailable(QueueBroadcast* queue, Queue_LenType reader) {
+    QueueBroadcast_PosType pos = Queue_atomicLoad(&queue->Readers[reader].Pos, QUEUE_ACQUIRE);
+    Queue_LenType len = (Queue_LenType) (Queue_atomicLoad(&queue->WPos, QUEUE_ACQUIRE) - pos);
+    Queue_LenType direct = (Queue_LenType) (__QueueBroadcast_capacity(queue) - (pos & queue->Mask));
+
+    return len < direct ? len : direct;
+}
+/**
+ * @brief return address of next item of reader, use with QueueBroadcast_directAvailable
+ * and QueueBroadcast_moveReadPos for zero-copy read
+ *
+ * @param queue
+ * @param reader reader index
+ * @return void*
+ */
+void* QueueBroadcast_getReadPtr(QueueBroadcast* queue, Queue_LenType reader) {
+    return __QueueBroadcast_ptr(queue, Queue_atomicLoad(&queue->Readers[reader].Pos, QUEUE_ACQUIRE));
+}
+/**
+ * @brief move reader forward, items between old and new position are released
+ *
+ * @param queue
+ * @param reader reader index
+ * @param len number of items
+ * @return Queue_Result QueueBroadcast_Lost if reader detached or skipped since it take read pointer
+ */
+Queue_Result QueueBroadcast_moveReadPos(QueueBroadcast* queue, Queue_LenType reader, Queue_LenType len) {
+    QueueBroadcast_Reader* cursor = &queue->Readers[reader];
+    QueueBroadcast_PosType pos = Queue_atomicLoad(&cursor->Pos, QUEUE_ACQUIRE);
+
+    if (Queue_atomicLoad(&queue->WPos, QUEUE_ACQUIRE) - pos < (QueueBroadcast_PosType) len) {
+        return Queue_NoAvailable;
+    }
+    Queue_atomicFence(QUEUE_ACQUIRE);
+    if (Queue_atomicLoad(&cursor->State, QUEUE_RELAXED) != QueueBroadcast_ReaderActive) {
+        return QueueBroadcast_Lost;
+    }
+    return Queue_atomicCas(&cursor->Pos, &pos, pos + (QueueBroadcast_PosType) len, QUEUE_ACQ_REL, QUEUE_RELAXED) ?
+                Queue_Ok : QueueBroadcast_Lost;
+}
+/**
+ * @brief read array of items for reader, it's all or nothing
+ * if writer skip reader while copy, copy is repeated from new position
+ *
+ * @param queue
+ * @param reader reader index
+ * @param val address of output items
+ * @param len number of items
+ * @return Queue_Result QueueBroadcast_Lost if reader detached
+ */
+Queue_Result QueueBroadcast_readArray(QueueBroadcast* queue, Queue_LenType reader, void* val, Queue_LenType len) {
+    QueueBroadcast_Reader* cursor = &queue->Readers[reader];
+    QueueBroadcast_PosType pos;
+
+#if STREAM_CHECK_ZERO_LEN
+    if (len == 0) {
+        return Queue_ZeroLen;
+    }
+#endif
+
+    for (;;) {
+        if (Queue_atomicLoad(&cursor->State, QUEUE_ACQUIRE) != QueueBroadcast_ReaderActive) {
+            return QueueBroadcast_Lost;
+        }
+        pos = Queue_atomicLoad(&cursor->Pos, QUEUE_ACQUIRE);
+        if (Queue_atomicLoad(&queue->WPos, QUEUE_ACQUIRE) - pos < (QueueBroadcast_PosType) len) {
+            return Queue_NoAvailable;
+        }
+        __QueueBroadcast_copy(queue, pos, (uint8_t*) val, len, 0);
+        // copied items must be read before check writer detach or skip this reader
+        Queue_atomicFence(QUEUE_ACQUIRE);
+        if (Queue_atomicLoad(&cursor->State, QUEUE_RELAXED) != QueueBroadcast_ReaderActive) {
+            return QueueBroadcast_Lost;
+        }
+        if (Queue_atomicCas(&cursor->Pos, &pos, pos + (QueueBroadcast_PosType) len, QUEUE_ACQ_REL, QUEUE_RELAXED)) {
+            return Queue_Ok;
+        }
+    }
+}
+/**
+ * @brief read items in place with custom query function, stop at first item that query reject
+ * reader move forward only for items that query accepted
+ *
+ * @param queue
+ * @param reader reader index
+ * @param len number of items
+ * @param query
+ * @return Queue_Result QueueBroadcast_Lost if reader detached or skipped while query items,
+ * in this case query may see overwritten items
+ */
+Queue_Result QueueBroadcast_readQueryArray(QueueBroadcast* queue, Queue_LenType reader, Queue_LenType len, QueueBroadcast_QueryFn query) {
+    QueueBroadcast_Reader* cursor = &queue->Readers[reader];
+    QueueBroadcast_PosType pos;
+    Queue_Result res = Queue_Ok;
+    Queue_LenType i = 0;
+
+#if STREAM_CHECK_ZERO_LEN
+    if (len == 0) {
+        return Queue_ZeroLen;
+    }
+#endif
+    if (Queue_atomicLoad(&cursor->State, QUEUE_ACQUIRE) != QueueBroadcast_ReaderActive) {
+        return QueueBroadcast_Lost;
+    }
+    pos = Queue_atomicLoad(&cursor->Pos, QUEUE_ACQUIRE);
+    if (Queue_atomicLoad(&queue->WPos, QUEUE_ACQUIRE) - pos < (QueueBroadcast_PosType) len) {
+        return Queue_NoAvailable;
+    }
+
+    while (i < len &&
+           (res = query(queue, reader, __QueueBroadcast_ptr(queue, pos + (QueueBroadcast_PosType) i), i, len)) == Queue_Ok
+    ) {
+        i++;
+    }
+
+    if (i > 0) {
+        Queue_atomicFence(QUEUE_ACQUIRE);
+        if (Queue_atomicLoad(&cursor->State, QUEUE_RELAXED) != QueueBroadcast_ReaderActive ||
+            !Queue_atomicCas(&cursor->Pos, &pos, pos + (QueueBroadcast_PosType) i, QUEUE_ACQ_REL, QUEUE_RELAXED)
+        ) {
+            return QueueBroadcast_Lost;
+        }
+    }
+
+    return res;
+}
+
+#endif // QUEUE_BROADCAST
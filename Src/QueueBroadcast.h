@@ -0,0 +1,136 @@
+/**
+ * @file QueueBroadcast.h
+ * @author Ali Mirghasemi (ali.mirghasemi1376@gmail.com)
+ * @brief single-writer broadcast queue, every registered reader see every item
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * There is one ring buffer with one write position and up to QUEUE_BROADCAST_MAX_READERS
+ * reader cursors, each item written once and read in place by all readers.
+ * Positions are free-running counters, capacity is power of 2, so index is pos & Mask.
+ * Free space is computed from slowest reader, when a reader lag too far behind
+ * LagPolicy decide writer get Queue_NoSpace (block), reader is detached or reader
+ * cursor moved forward (skip).
+ *
+ * Writer and each reader can run in separate threads without lock, each reader
+ * cursor must be used by one thread at a time.
+ */
+#ifndef _QUEUE_BROADCAST_H_
+#define _QUEUE_BROADCAST_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Queue.h"
+
+/************************************************************************/
+/*                            Configuration                             */
+/************************************************************************/
+/**
+ * @brief enable broadcast queue library
+ */
+#ifndef QUEUE_BROADCAST
+    #define QUEUE_BROADCAST                         0
+#endif
+/**
+ * @brief maximum number of readers of each broadcast queue
+ */
+#define QUEUE_BROADCAST_MAX_READERS                 8
+/**
+ * @brief type of positions, must be unsigned, wrap around is fine
+ */
+typedef uint32_t QueueBroadcast_PosType;
+/************************************************************************/
+
+#if QUEUE_BROADCAST && QUEUE
+
+/**
+ * @brief returned by reader APIs when reader detached, or items skipped by writer while reader query them
+ */
+#define QueueBroadcast_Lost                         Queue_CustomError
+
+/**
+ * @brief what writer do with readers that block a write
+ */
+typedef enum {
+    QueueBroadcast_LagBlock         = 0,    /**< writer get Queue_NoSpace until slowest reader catch up */
+    QueueBroadcast_LagDetach        = 1,    /**< lagging reader detached, its reads return QueueBroadcast_Lost */
+    QueueBroadcast_LagSkip          = 2,    /**< lagging reader moved forward, it lose oldest items */
+} QueueBroadcast_LagPolicy;
+/**
+ * @brief state of reader cursor
+ */
+typedef enum {
+    QueueBroadcast_ReaderFree       = 0,
+    QueueBroadcast_ReaderActive     = 1,
+    QueueBroadcast_ReaderDetached   = 2,
+} QueueBroadcast_ReaderState;
+/**
+ * @brief reader cursor, each one in separate cache line
+ */
+typedef struct {
+    QueueBroadcast_PosType  Pos;                        /**< next item that reader read */
+    uint32_t                Skipped;                    /**< number of items skipped by writer */
+    uint32_t                State;                      /**< QueueBroadcast_ReaderState */
+    uint8_t                 __pad[QUEUE_CACHE_LINE_SIZE - sizeof(QueueBroadcast_PosType) - 2 * sizeof(uint32_t)];
+} QueueBroadcast_Reader;
+/**
+ * @brief QueueBroadcast struct
+ */
+typedef struct {
+    QueueBroadcast_PosType  WPos;                       /**< next item that writer write */
+    QueueBroadcast_PosType  MinPos;                     /**< cached position of slowest reader, writer side */
+    uint8_t                 __padWrite[QUEUE_CACHE_LINE_SIZE - 2 * sizeof(QueueBroadcast_PosType)];
+    QueueBroadcast_Reader   Readers[QUEUE_BROADCAST_MAX_READERS];
+    uint8_t*                Data;                       /**< queue buffer */
+    QueueBroadcast_PosType  Mask;                       /**< number of items - 1 */
+    Queue_LenType           ItemSize;                   /**< length of each item */
+    uint8_t                 LagPolicy;                  /**< QueueBroadcast_LagPolicy */
+} QueueBroadcast;
+/**
+ * @brief read items in place with custom function
+ * @param queue pointer to queue
+ * @param reader reader index
+ * @param val pointer to item
+ * @param index index of item
+ * @param len number of items
+ * @return Queue_Result
+ */
+typedef Queue_Result (*QueueBroadcast_QueryFn)(QueueBroadcast* queue, Queue_LenType reader, const void* val, Queue_LenType index, Queue_LenType len);
+
+Queue_Result        QueueBroadcast_init(QueueBroadcast* queue, void* buffer, Queue_LenType size, Queue_LenType itemSize, QueueBroadcast_LagPolicy policy);
+void                QueueBroadcast_deinit(QueueBroadcast* queue);
+
+Queue_LenType       QueueBroadcast_addReader(QueueBroadcast* queue);
+void                QueueBroadcast_removeReader(QueueBroadcast* queue, Queue_LenType reader);
+
+#define             QueueBroadcast_getBufferSize(QUEUE)                     ((Queue_LenType) (QUEUE)->Mask + 1)
+#define             QueueBroadcast_getReaderState(QUEUE, READER)            ((QueueBroadcast_ReaderState) (QUEUE)->Readers[(READER)].State)
+#define             QueueBroadcast_getSkipped(QUEUE, READER)                ((QUEUE)->Readers[(READER)].Skipped)
+
+/**************** Write APIs **************/
+Queue_LenType       QueueBroadcast_space(QueueBroadcast* queue);
+
+#define             QueueBroadcast_write(QUEUE, VAL)                        QueueBroadcast_writeArray((QUEUE), (VAL), 1)
+Queue_Result        QueueBroadcast_writeArray(QueueBroadcast* queue, const void* val, Queue_LenType len);
+
+/**************** Read APIs **************/
+Queue_LenType       QueueBroadcast_available(QueueBroadcast* queue, Queue_LenType reader);
+Queue_LenType       QueueBroadcast_directAvailable(QueueBroadcast* queue, Queue_LenType reader);
+void*               QueueBroadcast_getReadPtr(QueueBroadcast* queue, Queue_LenType reader);
+Queue_Result        QueueBroadcast_moveReadPos(QueueBroadcast* queue, Queue_LenType reader, Queue_LenType len);
+
+#define             QueueBroadcast_read(QUEUE, READER, VAL)                 QueueBroadcast_readArray((QUEUE), (READER), (VAL), 1)
+Queue_Result        QueueBroadcast_readArray(QueueBroadcast* queue, Queue_LenType reader, void* val, Queue_LenType len);
+Queue_Result        QueueBroadcast_readQueryArray(QueueBroadcast* queue, Queue_LenType reader, Queue_LenType len, QueueBroadcast_QueryFn query);
+
+#endif // QUEUE_BROADCAST
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _QUEUE_BROADCAST_H_ */
@@ -0,0 +1,171 @@
+#include "QueueGroup.h"
+
+#if QUEUE_GROUP && QUEUE_MPMC && QUEUE
+
+/**
+ * @brief read up to len items from shard, start with available items of shard
+ * and halve batch until shard can serve it, other consumers may take items at same time
+ *
+ * @return Queue_LenType number of items read
+ */
+static Queue_LenType __QueueGroup_readShard(QueueMPMC* shard, void* val, Queue_LenType len) {
+    Queue_LenType available = QueueMPMC_available(shard);
+
+    if (len > available) {
+        len = available;
+    }
+    while (len > 0) {
+        if (QueueMPMC_readArray(shard, val, len) == Queue_Ok) {
+            return len;
+        }
+        if (QueueMPMC_isEmpty(shard)) {
+            break;
+        }
+        len >>= 1;
+    }
+    return 0;
+}
+/**
+ * @brief initialize queue group, buffer split into count shards
+ *
+ * @param group address of group struct
+ * @param shards array of count QueueMPMC structs
+ * @param count number of shards
+ * @param buffer address of buffer, must be aligned to QUEUE_MPMC_CELL_ALIGN
+ * @param shardSize size of each shard in bytes, use QueueMPMC_bufferSize for calculate it
+ * @param itemSize size of each item
+ * @return Queue_Result Queue_NoSpace if there is no shard or shardSize can't hold one item,
+ * group has no shard in this case
+ */
+Queue_Result QueueGroup_init(QueueGroup* group, QueueMPMC* shards, Queue_LenType count, void* buffer, Queue_LenType shardSize, Queue_LenType itemSize) {
+    Queue_LenType i;
+
+    group->Shards = shards;
+    group->Count = 0;
+    group->ItemSize = itemSize;
+    if (shards == NULL || buffer == NULL || count <= 0) {
+        return Queue_NoSpace;
+    }
+    for (i = 0; i < count; i++) {
+        if (QueueMPMC_init(&shards[i], (uint8_t*) buffer + i * shardSize, shardSize, itemSize) != Queue_Ok) {
+            group->Count = i;
+            QueueGroup_deinit(group);
+            return Queue_NoSpace;
+        }
+    }
+    group->Count = count;
+    return Queue_Ok;
+}
+/**
+ * @brief de-initialize queue group
+ *
+ * @param group
+ */
+void QueueGroup_deinit(QueueGroup* group) {
+    Queue_LenType i;
+
+    for (i = 0; i < group->Count; i++) {
+        QueueMPMC_deinit(&group->Shards[i]);
+    }
+    group->Shards = NULL;
+    group->Count = 0;
+    group->ItemSize = 0;
+}
+/**
+ * @brief return number of items in all shards, it's a snapshot
+ *
+ * @param group
+ * @return Queue_LenType
+ */
+Queue_LenType QueueGroup_available(QueueGroup* group) {
+    Queue_LenType len = 0;
+    Queue_LenType i;
+
+    for (i = 0; i < group->Count; i++) {
+        len += QueueMPMC_available(&group->Shards[i]);
+    }
+    return len;
+}
+/**
+ * @brief return number of free items in all shards, it's a snapshot
+ *
+ * @param group
+ * @return Queue_LenType
+ */
+Queue_LenType QueueGroup_space(QueueGroup* group) {
+    Queue_LenType len = 0;
+    Queue_LenType i;
+
+    for (i = 0; i < group->Count; i++) {
+        len += QueueMPMC_space(&group->Shards[i]);
+    }
+    return len;
+}
+/**
+ * @brief write array of items into given shard, shard index wrap around number of shards
+ *
+ * @param group
+ * @param shard shard of producer
+ * @param val address of items
+ * @param len number of items
+ * @return Queue_Result Queue_NoSpace if group has no shard
+ */
+Queue_Result QueueGroup_writeArray(QueueGroup* group, Queue_LenType shard, const void* val, Queue_LenType len) {
+    if (group->Count <= 0) {
+        return Queue_NoSpace;
+    }
+    return QueueMPMC_writeArray(&group->Shards[(uint32_t) shard % (uint32_t) group->Count], val, len);
+}
+/**
+ * @brief write item into shard of key, items with same key keep their order
+ *
+ * @param group
+ * @param key
+ * @param val address of item
+ * @return Queue_Result Queue_NoSpace if group has no shard
+ */
+Queue_Result QueueGroup_writeKey(QueueGroup* group, uint32_t key, const void* val) {
+    if (group->Count <= 0) {
+        return Queue_NoSpace;
+    }
+    return QueueMPMC_write(&group->Shards[key % (uint32_t) group->Count], val);
+}
+/**
+ * @brief read one item from home shard, or steal it from other shards
+ *
+ * @param group
+ * @param home home shard of consumer
+ * @param val address of output item
+ * @return Queue_Result
+ */
+Queue_Result QueueGroup_read(QueueGroup* group, Queue_LenType home, void* val) {
+    return QueueGroup_readArray(group, home, val, 1) > 0 ? Queue_Ok : Queue_NoAvailable;
+}
+/**
+ * @brief read up to len items from home shard, if it's empty steal from other shards
+ * in order after home, all items of one call come from one shard
+ *
+ * @param group
+ * @param home home shard of consumer
+ * @param val address of output items
+ * @param len maximum number of items
+ * @return Queue_LenType number of items read, 0 if all shards are empty
+ */
+Queue_LenType QueueGroup_readArray(QueueGroup* group, Queue_LenType home, void* val, Queue_LenType len) {
+    Queue_LenType read;
+    Queue_LenType i;
+
+    if (group->Count <= 0) {
+        return 0;
+    }
+    home %= group->Count;
+    for (i = 0; i < group->Count; i++) {
+        read = __QueueGroup_readShard(&group->Shards[(home + i) % group->Count], val, len);
+        if (read > 0) {
+            return read;
+        }
+    }
+    return 0;
+}
+
+#endif // QUEUE_GROUP
@@ -0,0 +1,79 @@
+/**
+ * @file QueueGroup.h
+ * @author Ali Mirghasemi (ali.mirghasemi1376@gmail.com)
+ * @brief group of sharded MPMC queues with work-stealing consumers
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Group own one QueueMPMC shard per producer or core, each producer write to its
+ * own shard so producers don't share cache lines. Consumers read their home shard
+ * and when it's empty steal batches from other shards, batch is halved until
+ * a shard can serve it.
+ * Items written with same key always go to same shard, so they are dequeued in FIFO order,
+ * there is no order between different shards.
+ *
+ * Example:
+ *  QueueMPMC shards[4];
+ *  uint8_t buffer[4 * QueueMPMC_bufferSize(256, sizeof(Job))];
+ *  QueueGroup_init(&group, shards, 4, buffer, QueueMPMC_bufferSize(256, sizeof(Job)), sizeof(Job));
+ *  QueueGroup_write(&group, producerId, &job);
+ *  QueueGroup_read(&group, consumerId, &job);
+ */
+#ifndef _QUEUE_GROUP_H_
+#define _QUEUE_GROUP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "QueueMPMC.h"
+
+/************************************************************************/
+/*                            Configuration                             */
+/************************************************************************/
+/**
+ * @brief enable queue group library, require QueueMPMC
+ */
+#ifndef QUEUE_GROUP
+    #define QUEUE_GROUP                             0
+#endif
+/************************************************************************/
+
+#if QUEUE_GROUP && QUEUE_MPMC && QUEUE
+
+/**
+ * @brief QueueGroup struct
+ */
+typedef struct {
+    QueueMPMC*              Shards;                     /**< array of shards */
+    Queue_LenType           Count;                      /**< number of shards */
+    Queue_LenType           ItemSize;                   /**< length of each item */
+} QueueGroup;
+
+Queue_Result        QueueGroup_init(QueueGroup* group, QueueMPMC* shards, Queue_LenType count, void* buffer, Queue_LenType shardSize, Queue_LenType itemSize);
+void                QueueGroup_deinit(QueueGroup* group);
+
+Queue_LenType       QueueGroup_available(QueueGroup* group);
+Queue_LenType       QueueGroup_space(QueueGroup* group);
+
+#define             QueueGroup_getShard(GROUP, SHARD)                       ((GROUP)->Count > 0 ? &(GROUP)->Shards[(uint32_t) (SHARD) % (uint32_t) (GROUP)->Count] : NULL)
+#define             QueueGroup_getShardCount(GROUP)                         ((GROUP)->Count)
+
+/**************** Write APIs **************/
+#define             QueueGroup_write(GROUP, SHARD, VAL)                     QueueGroup_writeArray((GROUP), (SHARD), (VAL), 1)
+Queue_Result        QueueGroup_writeArray(QueueGroup* group, Queue_LenType shard, const void* val, Queue_LenType len);
+Queue_Result        QueueGroup_writeKey(QueueGroup* group, uint32_t key, const void* val);
+
+/**************** Read APIs **************/
+Queue_Result        QueueGroup_read(QueueGroup* group, Queue_LenType home, void* val);
+Queue_LenType       QueueGroup_readArray(QueueGroup* group, Queue_LenType home, void* val, Queue_LenType len);
+
+#endif // QUEUE_GROUP
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _QUEUE_GROUP_H_ */
@@ -0,0 +1,205 @@
+#include "QueueMPMC.h"
+
+#if QUEUE_MPMC && QUEUE
+
+#include "QueueAtomic.h"
+#include <string.h>
+
+#define __QueueMPMC_cell(QUEUE, POS)                ((QUEUE)->Data + ((POS) & (QUEUE)->Mask) * (QUEUE)->CellSize)
+#define __QueueMPMC_seq(CELL)                       ((QueueMPMC_SeqType*) (CELL))
+#define __QueueMPMC_item(CELL)                      ((CELL) + QUEUE_MPMC_CELL_ALIGN)
+
+/**
+ * @brief initialize MPMC queue
+ * number of cells is rounded down to power of 2
+ *
+ * @param queue address of queue struct
+ * @param buffer address of byte buffer, must be aligned to QUEUE_MPMC_CELL_ALIGN
+ * @param size size of buffer, use QueueMPMC_bufferSize for calculate it
+ * @param itemSize size of each item
+ * @return Queue_Result Queue_NoSpace if buffer can't hold one cell, queue has zero capacity
+ */
+Queue_Result QueueMPMC_init(QueueMPMC* queue, void* buffer, Queue_LenType size, Queue_LenType itemSize) {
+    QueueMPMC_SeqType cells = 1;
+    QueueMPMC_SeqType i;
+
+    if (buffer == NULL || itemSize <= 0 || size < QueueMPMC_cellSize(itemSize)) {
+        QueueMPMC_deinit(queue);
+        return Queue_NoSpace;
+    }
+    queue->Data = (uint8_t*) buffer;
+    queue->ItemSize = itemSize;
+    queue->CellSize = QueueMPMC_cellSize(itemSize);
+    // round down number of cells to power of 2
+    while ((Queue_LenType) (cells << 1) * queue->CellSize <= size) {
+        cells <<= 1;
+    }
+    queue->Mask = cells - 1;
+    // each cell is free for first lap
+    for (i = 0; i < cells; i++) {
+        *__QueueMPMC_seq(__QueueMPMC_cell(queue, i)) = i;
+    }
+    queue->EnqueuePos = 0;
+    queue->DequeuePos = 0;
+    Queue_atomicFence(QUEUE_SEQ_CST);
+    return Queue_Ok;
+}
+/**
+ * @brief de-initialize MPMC queue
+ *
+ * @param queue
+ */
+void QueueMPMC_deinit(QueueMPMC* queue) {
+    queue->Data = NULL;
+    queue->Mask = 0;
+    queue->ItemSize = 0;
+    queue->CellSize = 0;
+    queue->EnqueuePos = 0;
+    queue->DequeuePos = 0;
+}
+/**
+ * @brief return number of items in queue, it's a snapshot and can be changed by other threads
+ *
+ * @param queue
+ * @return Queue_LenType
+ */
+Queue_LenType QueueMPMC_available(QueueMPMC* queue) {
+    QueueMPMC_SeqType deq = Queue_atomicLoad(&queue->DequeuePos, QUEUE_ACQUIRE);
+    QueueMPMC_SeqType enq = Queue_atomicLoad(&queue->EnqueuePos, QUEUE_ACQUIRE);
+    QueueMPMC_SeqDiffType len = (QueueMPMC_SeqDiffType) (enq - deq);
+
+    if (len < 0 || queue->Data == NULL) {
+        return 0;
+    }
+    else if ((QueueMPMC_SeqType) len > queue->Mask + 1) {
+        return (Queue_LenType) queue->Mask + 1;
+    }
+    return (Queue_LenType) len;
+}
+/**
+ * @brief return number of free items in queue, it's a snapshot and can be changed by other threads
+ *
+ * @param queue
+ * @return Queue_LenType
+ */
+Queue_LenType QueueMPMC_space(QueueMPMC* queue) {
+    return QueueMPMC_getBufferSize(queue) - QueueMPMC_available(queue);
+}
+/**
+ * @brief write array of items into queue, it's all or nothing
+ * all cells claimed with a single CAS
+ *
+ * @param queue
+ * @param val address of items
+ * @param len number of items
+ * @return Queue_Result
+ */
+Queue_Result QueueMPMC_writeArray(QueueMPMC* queue, const void* val, Queue_LenType len) {
+    QueueMPMC_SeqType pos;
+    QueueMPMC_SeqDiffType dif = 0;
+    Queue_LenType i;
+    uint8_t* cell;
+
+#if STREAM_CHECK_ZERO_LEN
+    if (len == 0) {
+        return Queue_ZeroLen;
+    }
+#endif
+    if ((QueueMPMC_SeqType) len > queue->Mask + 1 || queue->Data == NULL) {
+        return Queue_NoSpace;
+    }
+
+    pos = Queue_atomicLoad(&queue->EnqueuePos, QUEUE_RELAXED);
+    for (;;) {
+        // all cells must be free for this lap
+        for (i = 0; i < len; i++) {
+            cell = __QueueMPMC_cell(queue, pos + i);
+            dif = (QueueMPMC_SeqDiffType) (Queue_atomicLoad(__QueueMPMC_seq(cell), QUEUE_ACQUIRE) - (pos + i));
+            if (dif != 0) {
+                break;
+            }
+        }
+        if (i == len) {
+            // claim cells, on failure pos updated with new value
+            if (Queue_atomicCas(&queue->EnqueuePos, &pos, pos + len, QUEUE_RELAXED, QUEUE_RELAXED)) {
+                break;
+            }
+        }
+        else if (dif < 0) {
+            // cell still hold item of previous lap
+            return Queue_NoSpace;
+        }
+        else {
+            // another producer claimed cells
+            pos = Queue_atomicLoad(&queue->EnqueuePos, QUEUE_RELAXED);
+        }
+    }
+    // copy items and publish them
+    for (i = 0; i < len; i++) {
+        cell = __QueueMPMC_cell(queue, pos + i);
+        memcpy(__QueueMPMC_item(cell), (const uint8_t*) val + i * queue->ItemSize, queue->ItemSize);
+        Queue_atomicStore(__QueueMPMC_seq(cell), pos + i + 1, QUEUE_RELEASE);
+    }
+
+    return Queue_Ok;
+}
+/**
+ * @brief read array of items from queue, it's all or nothing
+ * all cells claimed with a single CAS
+ *
+ * @param queue
+ * @param val address of output items
+ * @param len number of items
+ * @return Queue_Result
+ */
+Queue_Result QueueMPMC_readArray(QueueMPMC* queue, void* val, Queue_LenType len) {
+    QueueMPMC_SeqType pos;
+    QueueMPMC_SeqDiffType dif = 0;
+    Queue_LenType i;
+    uint8_t* cell;
+
+#if STREAM_CHECK_ZERO_LEN
+    if (len == 0) {
+        return Queue_ZeroLen;
+    }
+#endif
+    if ((QueueMPMC_SeqType) len > queue->Mask + 1 || queue->Data == NULL) {
+        return Queue_NoAvailable;
+    }
+
+    pos = Queue_atomicLoad(&queue->DequeuePos, QUEUE_RELAXED);
+    for (;;) {
+        // all cells must be published for this lap
+        for (i = 0; i < len; i++) {
+            cell = __QueueMPMC_cell(queue, pos + i);
+            dif = (QueueMPMC_SeqDiffType) (Queue_atomicLoad(__QueueMPMC_seq(cell), QUEUE_ACQUIRE) - (pos + i + 1));
+            if (dif != 0) {
+                break;
+            }
+        }
+        if (i == len) {
+            // claim cells, on failure pos updated with new value
+            if (Queue_atomicCas(&queue->DequeuePos, &pos, pos + len, QUEUE_RELAXED, QUEUE_RELAXED)) {
+                break;
+            }
+        }
+        else if (dif < 0) {
+            // cell not published yet
+            return Queue_NoAvailable;
+        }
+        else {
+            // another consumer claimed cells
+            pos = Queue_atomicLoad(&queue->DequeuePos, QUEUE_RELAXED);
+        }
+    }
+    // copy items and free cells for next lap
+    for (i = 0; i < len; i++) {
+        cell = __QueueMPMC_cell(queue, pos + i);
+        memcpy((uint8_t*) val + i * queue->ItemSize, __QueueMPMC_item(cell), queue->ItemSize);
+        Queue_atomicStore(__QueueMPMC_seq(cell), pos + i + queue->Mask + 1, QUEUE_RELEASE);
+    }
+
+    return Queue_Ok;
+}
+
+#endif // QUEUE_MPMC
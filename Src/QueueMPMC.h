@@ -0,0 +1,108 @@
+/**
+ * @file QueueMPMC.h
+ * @author Ali Mirghasemi (ali.mirghasemi1376@gmail.com)
+ * @brief bounded multi-producer/multi-consumer non-blocking queue for fixed size items
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Each cell of buffer holds a sequence number next to item, producers and consumers
+ * claim cells with a single CAS on EnqueuePos/DequeuePos and publish them by store
+ * new sequence of cell, so there is no global lock.
+ *
+ * Progress guarantee:
+ *  - claim is non-blocking, a failed CAS means another thread claimed cells,
+ *    so some thread always succeed to claim
+ *  - queue is NOT lock-free as a whole, claim and publish are two steps, if a producer
+ *    claimed a cell and preempted before publish it, consumers that reach that cell
+ *    see it as not ready and get Queue_NoAvailable until that producer resume, even when
+ *    cells after it are published, same for producers behind a preempted consumer
+ *    with Queue_NoSpace
+ *  - calls never block or spin on a not ready cell, they return and caller decide to retry
+ *  - producers only touch EnqueuePos and consumers only touch DequeuePos, both are
+ *    in separate cache lines, so producers and consumers don't contend each other
+ */
+#ifndef _QUEUE_MPMC_H_
+#define _QUEUE_MPMC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Queue.h"
+
+/************************************************************************/
+/*                            Configuration                             */
+/************************************************************************/
+/**
+ * @brief enable MPMC queue library, require GCC or Clang atomic builtins
+ */
+#ifndef QUEUE_MPMC
+    #define QUEUE_MPMC                              0
+#endif
+/**
+ * @brief alignment of items in cells, sequence number placed before item
+ * so item offset in cell is equal to this value, must be >= sizeof(QueueMPMC_SeqType)
+ */
+#define QUEUE_MPMC_CELL_ALIGN                       8
+/**
+ * @brief type of sequence numbers, must be unsigned, wrap around is fine
+ */
+typedef uint32_t QueueMPMC_SeqType;
+/**
+ * @brief signed type with same size of QueueMPMC_SeqType, used for compare sequences
+ */
+typedef int32_t QueueMPMC_SeqDiffType;
+/************************************************************************/
+
+#if QUEUE_MPMC && QUEUE
+
+/**
+ * @brief size of each cell in buffer for given item size
+ */
+#define QueueMPMC_cellSize(ITEM_SIZE)               ((((ITEM_SIZE) + QUEUE_MPMC_CELL_ALIGN - 1) / QUEUE_MPMC_CELL_ALIGN + 1) * QUEUE_MPMC_CELL_ALIGN)
+/**
+ * @brief size of buffer that need for given capacity and item size, capacity must be power of 2
+ */
+#define QueueMPMC_bufferSize(CAP, ITEM_SIZE)        ((CAP) * QueueMPMC_cellSize(ITEM_SIZE))
+
+/**
+ * @brief QueueMPMC struct
+ */
+typedef struct {
+    QueueMPMC_SeqType       EnqueuePos;                 /**< next cell that producers claim */
+    uint8_t                 __padEnqueue[QUEUE_CACHE_LINE_SIZE - sizeof(QueueMPMC_SeqType)];
+    QueueMPMC_SeqType       DequeuePos;                 /**< next cell that consumers claim */
+    uint8_t                 __padDequeue[QUEUE_CACHE_LINE_SIZE - sizeof(QueueMPMC_SeqType)];
+    uint8_t*                Data;                       /**< queue buffer, array of cells */
+    QueueMPMC_SeqType       Mask;                       /**< number of cells - 1 */
+    Queue_LenType           ItemSize;                   /**< length of each item */
+    Queue_LenType           CellSize;                   /**< length of each cell */
+} QueueMPMC;
+
+Queue_Result        QueueMPMC_init(QueueMPMC* queue, void* buffer, Queue_LenType size, Queue_LenType itemSize);
+void                QueueMPMC_deinit(QueueMPMC* queue);
+
+Queue_LenType       QueueMPMC_available(QueueMPMC* queue);
+Queue_LenType       QueueMPMC_space(QueueMPMC* queue);
+
+#define             QueueMPMC_isEmpty(QUEUE)                                (QueueMPMC_available(QUEUE) == 0)
+#define             QueueMPMC_isFull(QUEUE)                                 (QueueMPMC_space(QUEUE) == 0)
+#define             QueueMPMC_getBufferSize(QUEUE)                          ((QUEUE)->Data != NULL ? (Queue_LenType) (QUEUE)->Mask + 1 : 0)
+
+/**************** Write APIs **************/
+#define             QueueMPMC_write(QUEUE, VAL)                             QueueMPMC_writeArray((QUEUE), (VAL), 1)
+Queue_Result        QueueMPMC_writeArray(QueueMPMC* queue, const void* val, Queue_LenType len);
+
+/**************** Read APIs **************/
+#define             QueueMPMC_read(QUEUE, VAL)                              QueueMPMC_readArray((QUEUE), (VAL), 1)
+Queue_Result        QueueMPMC_readArray(QueueMPMC* queue, void* val, Queue_LenType len);
+
+#endif // QUEUE_MPMC
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _QUEUE_MPMC_H_ */
@@ -0,0 +1,272 @@
+#include "QueueMapped.h"
+
+#if QUEUE_MAPPED
+
+#include "QueueAtomic.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define __QueueMapped_data(MAPPED)                  ((uint8_t*) (MAPPED)->Header + __QueueMapped_headerSize())
+
+static size_t __QueueMapped_headerSize(void) {
+    return (size_t) sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * @brief greatest common divisor, used for align data size to page and item size
+ */
+static size_t __QueueMapped_gcd(size_t a, size_t b) {
+    size_t t;
+
+    while (b != 0) {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static uint32_t __QueueMapped_getTick(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t) (ts.tv_sec * 1000UL + ts.tv_nsec / 1000000L);
+}
+/**
+ * @brief FNV-1a checksum over commit fields and geometry of queue
+ */
+static uint32_t __QueueMapped_checksum(const QueueMapped_Header* header, const QueueMapped_Commit* commit) {
+    uint32_t fields[5];
+    const uint8_t* p = (const uint8_t*) fields;
+    uint32_t hash = 2166136261UL;
+    size_t i;
+
+    fields[0] = commit->Generation;
+    fields[1] = commit->RPos;
+    fields[2] = commit->Len;
+    fields[3] = header->Size;
+    fields[4] = header->ItemSize;
+    for (i = 0; i < sizeof(fields); i++) {
+        hash = (hash ^ p[i]) * 16777619UL;
+    }
+    return hash;
+}
+
+static uint8_t __QueueMapped_isValid(const QueueMapped_Header* header, const QueueMapped_Commit* commit) {
+    return commit->Checksum == __QueueMapped_checksum(header, commit) &&
+           commit->RPos < header->Size &&
+           commit->Len <= header->Size &&
+           commit->Len % header->ItemSize == 0;
+}
+/**
+ * @brief flush data then header, so header never point to data that not on disk
+ */
+static void __QueueMapped_sync(QueueMapped* mapped) {
+    msync(__QueueMapped_data(mapped), mapped->MapSize - __QueueMapped_headerSize(), MS_SYNC);
+    msync(mapped->Header, __QueueMapped_headerSize(), MS_SYNC);
+    mapped->LastSync = __QueueMapped_getTick();
+}
+/**
+ * @brief store current positions in next commit slot and msync based on policy
+ *
+ * @param mapped
+ * @param item 1 if called after single item operation
+ */
+static Queue_Result __QueueMapped_commit(QueueMapped* mapped, uint8_t item) {
+    QueueMapped_Commit* commit;
+    uint32_t generation = mapped->Generation + 1;
+
+    commit = &mapped->Header->Commits[generation & 1];
+    // data stores must be visible before new positions
+    Queue_atomicFence(QUEUE_RELEASE);
+    commit->Generation = generation;
+    commit->RPos = (uint32_t) Queue_getReadPosRaw(&mapped->Base);
+    commit->Len = (uint32_t) Queue_availableRaw(&mapped->Base);
+    commit->Checksum = __QueueMapped_checksum(mapped->Header, commit);
+    mapped->Generation = generation;
+
+    switch (mapped->SyncPolicy) {
+        case Queue_SyncItem:
+            __QueueMapped_sync(mapped);
+            break;
+        case Queue_SyncBatch:
+            if (!item) {
+                __QueueMapped_sync(mapped);
+            }
+            break;
+        case Queue_SyncPeriodic:
+            if (__QueueMapped_getTick() - mapped->LastSync >= mapped->SyncPeriod) {
+                __QueueMapped_sync(mapped);
+            }
+            break;
+        default:
+            break;
+    }
+
+    return Queue_Ok;
+}
+/**
+ * @brief open or create file-backed queue, if file has a valid header with same geometry
+ * queue recovered to last commit, otherwise file is initialized as empty queue
+ * buffer size is capacity * itemSize rounded up to multiple of both page size and item size,
+ * so buffer hold whole items
+ *
+ * @param mapped address of QueueMapped struct
+ * @param path path of file
+ * @param capacity minimum number of items
+ * @param itemSize size of each item
+ * @return Queue_Result Queue_Ok or Queue_CustomError if arguments are invalid or file can't be mapped
+ */
+Queue_Result Queue_openMapped(QueueMapped* mapped, const char* path, Queue_LenType capacity, Queue_LenType itemSize) {
+    size_t headerSize = __QueueMapped_headerSize();
+    size_t size = (size_t) capacity * (size_t) itemSize;
+    size_t align;
+    QueueMapped_Header* header;
+    QueueMapped_Commit* last = NULL;
+    struct stat st;
+    int fd;
+
+    if (capacity <= 0 || itemSize <= 0) {
+        return Queue_CustomError;
+    }
+    // data size must be multiple of page size and item size
+    align = headerSize / __QueueMapped_gcd(headerSize, (size_t) itemSize) * (size_t) itemSize;
+    size = (size + align - 1) / align * align;
+    if (size == 0 || (Queue_LenType) size < 0 || (size_t) (Queue_LenType) size != size) {
+        return Queue_CustomError;
+    }
+
+    fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return Queue_CustomError;
+    }
+    if (fstat(fd, &st) != 0 ||
+        ((size_t) st.st_size != headerSize + size && ftruncate(fd, (off_t) (headerSize + size)) != 0)
+    ) {
+        close(fd);
+        return Queue_CustomError;
+    }
+    header = (QueueMapped_Header*) mmap(NULL, headerSize + size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (header == MAP_FAILED) {
+        close(fd);
+        return Queue_CustomError;
+    }
+
+    mapped->Header = header;
+    mapped->MapSize = headerSize + size;
+    mapped->Fd = fd;
+    mapped->SyncPolicy = Queue_SyncNone;
+    mapped->SyncPeriod = 0;
+    mapped->LastSync = __QueueMapped_getTick();
+    Queue_init(&mapped->Base, __QueueMapped_data(mapped), (Queue_LenType) size, itemSize);
+
+    // find last valid commit
+    if (header->Magic == QUEUE_MAPPED_MAGIC &&
+        header->Version == QUEUE_MAPPED_VERSION &&
+        header->Size == (uint32_t) size &&
+        header->ItemSize == (uint32_t) itemSize
+    ) {
+        uint8_t valid0 = __QueueMapped_isValid(header, &header->Commits[0]);
+        uint8_t valid1 = __QueueMapped_isValid(header, &header->Commits[1]);
+        if (valid0 && valid1) {
+            last = (int32_t) (header->Commits[1].Generation - header->Commits[0].Generation) > 0 ?
+                        &header->Commits[1] : &header->Commits[0];
+        }
+        else if (valid0) {
+            last = &header->Commits[0];
+        }
+        else if (valid1) {
+            last = &header->Commits[1];
+        }
+    }
+
+    if (last != NULL) {
+        // restore positions with stream APIs: move both to RPos then write Len bytes
+        mapped->Generation = last->Generation;
+        Queue_moveWritePosRaw(&mapped->Base, (Queue_LenType) last->RPos);
+        Queue_moveReadPosRaw(&mapped->Base, (Queue_LenType) last->RPos);
+        Queue_moveWritePosRaw(&mapped->Base, (Queue_LenType) last->Len);
+    }
+    else {
+        // new or invalid file, start with empty queue
+        header->Magic = QUEUE_MAPPED_MAGIC;
+        header->Version = QUEUE_MAPPED_VERSION;
+        header->Size = (uint32_t) size;
+        header->ItemSize = (uint32_t) itemSize;
+        header->Commits[0].Generation = 0;
+        header->Commits[0].Checksum = 0;
+        mapped->Generation = 0;
+        __QueueMapped_commit(mapped, 0);
+        __QueueMapped_sync(mapped);
+    }
+
+    return Queue_Ok;
+}
+/**
+ * @brief commit positions, flush them to disk and unmap file
+ *
+ * @param mapped
+ */
+void Queue_closeMapped(QueueMapped* mapped) {
+    if (mapped->Header != NULL) {
+        __QueueMapped_commit(mapped, 0);
+        __QueueMapped_sync(mapped);
+        munmap(mapped->Header, mapped->MapSize);
+        close(mapped->Fd);
+        mapped->Header = NULL;
+        mapped->Fd = -1;
+    }
+    Queue_deinit(&mapped->Base);
+}
+/**
+ * @brief set msync policy
+ *
+ * @param mapped
+ * @param policy
+ * @param period period of Queue_SyncPeriodic in ms
+ */
+void Queue_setMappedSync(QueueMapped* mapped, Queue_SyncPolicy policy, uint32_t period) {
+    mapped->SyncPolicy = (uint8_t) policy;
+    mapped->SyncPeriod = period;
+}
+/**
+ * @brief commit current positions, call it after a batch of Queue_* operations
+ *
+ * @param mapped
+ * @return Queue_Result
+ */
+Queue_Result Queue_commitMapped(QueueMapped* mapped) {
+    return __QueueMapped_commit(mapped, 0);
+}
+/**
+ * @brief write item and commit it
+ *
+ * @param mapped
+ * @param val
+ * @return Queue_Result
+ */
+Queue_Result Queue_writeMapped(QueueMapped* mapped, const void* val) {
+    Queue_Result res = Queue_write(&mapped->Base, val);
+    if (res == Queue_Ok) {
+        res = __QueueMapped_commit(mapped, 1);
+    }
+    return res;
+}
+/**
+ * @brief read item and commit it
+ *
+ * @param mapped
+ * @param val
+ * @return Queue_Result
+ */
+Queue_Result Queue_readMapped(QueueMapped* mapped, void* val) {
+    Queue_Result res = Queue_read(&mapped->Base, val);
+    if (res == Queue_Ok) {
+        res = __QueueMapped_commit(mapped, 1);
+    }
+    return res;
+}
+
+#endif // QUEUE_MAPPED
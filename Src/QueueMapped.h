@@ -0,0 +1,104 @@
+/**
+ * @file QueueMapped.h
+ * @author Ali Mirghasemi (ali.mirghasemi1376@gmail.com)
+ * @brief file-backed persistent queue with crash recovery, POSIX only
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * Queue buffer is a memory-mapped file, first page of file is a header that keep
+ * two commit slots {Generation, RPos, Len, Checksum}, each commit write the slot
+ * that not hold the last commit, so a torn commit never destroy the previous one.
+ * On open, valid slot with higher generation is restored, startup is O(1) in queue size.
+ *
+ * Items written after last commit are lost on crash, Queue_writeMapped/Queue_readMapped
+ * commit after each item, or use Queue_* APIs on mapped->Base and call Queue_commitMapped
+ * after each batch.
+ */
+#ifndef _QUEUE_MAPPED_H_
+#define _QUEUE_MAPPED_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Queue.h"
+#include <stddef.h>
+
+/************************************************************************/
+/*                            Configuration                             */
+/************************************************************************/
+/**
+ * @brief enable memory-mapped persistent queue, require POSIX mmap
+ */
+#ifndef QUEUE_MAPPED
+    #define QUEUE_MAPPED                            0
+#endif
+/************************************************************************/
+
+#if QUEUE_MAPPED
+
+#define QUEUE_MAPPED_MAGIC                          0x5155454DUL    /**< "QUEM" */
+#define QUEUE_MAPPED_VERSION                        1
+
+/**
+ * @brief when positions flushed to disk with msync
+ * without msync, committed positions survive process crash but not power loss
+ */
+typedef enum {
+    Queue_SyncNone          = 0,    /**< never call msync, let kernel flush pages */
+    Queue_SyncItem          = 1,    /**< msync on every commit, include per item commits */
+    Queue_SyncBatch         = 2,    /**< msync only on Queue_commitMapped */
+    Queue_SyncPeriodic      = 3,    /**< msync on commit when sync period elapsed */
+} Queue_SyncPolicy;
+/**
+ * @brief one commit of positions, protected with checksum
+ */
+typedef struct {
+    uint32_t                Generation;                 /**< increased on each commit */
+    uint32_t                RPos;                       /**< read position in bytes */
+    uint32_t                Len;                        /**< number of bytes in queue */
+    uint32_t                Checksum;                   /**< checksum of other fields */
+} QueueMapped_Commit;
+/**
+ * @brief header of mapped file
+ */
+typedef struct {
+    uint32_t                Magic;                      /**< QUEUE_MAPPED_MAGIC */
+    uint32_t                Version;                    /**< QUEUE_MAPPED_VERSION */
+    uint32_t                Size;                       /**< size of data part in bytes */
+    uint32_t                ItemSize;                   /**< length of each item */
+    QueueMapped_Commit      Commits[2];                 /**< last two commits */
+} QueueMapped_Header;
+/**
+ * @brief QueueMapped struct
+ * use Base field with normal Queue_* APIs
+ */
+typedef struct {
+    Queue                   Base;                       /**< queue that buffer is mapped file */
+    QueueMapped_Header*     Header;                     /**< start of mapped file */
+    size_t                  MapSize;                    /**< size of mapped file */
+    int                     Fd;                         /**< file descriptor */
+    uint32_t                Generation;                 /**< generation of last commit */
+    uint32_t                SyncPeriod;                 /**< period of Queue_SyncPeriodic in ms */
+    uint32_t                LastSync;                   /**< tick of last msync in ms */
+    uint8_t                 SyncPolicy;                 /**< Queue_SyncPolicy */
+} QueueMapped;
+
+Queue_Result        Queue_openMapped(QueueMapped* mapped, const char* path, Queue_LenType capacity, Queue_LenType itemSize);
+void                Queue_closeMapped(QueueMapped* mapped);
+void                Queue_setMappedSync(QueueMapped* mapped, Queue_SyncPolicy policy, uint32_t period);
+
+Queue_Result        Queue_commitMapped(QueueMapped* mapped);
+
+Queue_Result        Queue_writeMapped(QueueMapped* mapped, const void* val);
+Queue_Result        Queue_readMapped(QueueMapped* mapped, void* val);
+
+#endif // QUEUE_MAPPED
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _QUEUE_MAPPED_H_ */
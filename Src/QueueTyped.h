@@ -0,0 +1,145 @@
+/**
+ * @file QueueTyped.h
+ * @author Ali Mirghasemi (ali.mirghasemi1376@gmail.com)
+ * @brief generator macro for queues that item type and capacity are fixed at compile time
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * QUEUE_DECLARE(NAME, TYPE, CAP) declare a struct that embed a normal Queue as first member
+ * and its own storage, and generate inline functions that use typed assignment instead of
+ * byte copy and constant item size instead of runtime ItemSize division.
+ * CAP must be power of 2, so item index wrap around with a mask.
+ * NAME_base return pointer to embedded Queue, so all Queue_* APIs work on it too.
+ *
+ * Typed queues are not protected by STREAM_MUTEX, generated write/read functions copy items
+ * directly into storage and only move positions with Stream APIs, so a queue that shared
+ * between threads must be guarded by caller, e.g. with Queue_mutexLock/Queue_mutexUnlock on NAME_base.
+ *
+ * Example:
+ *  QUEUE_DECLARE(MsgQueue, Message, 32)
+ *  MsgQueue msgQueue;
+ *  MsgQueue_init(&msgQueue);
+ *  MsgQueue_write(&msgQueue, &msg);
+ */
+#ifndef _QUEUE_TYPED_H_
+#define _QUEUE_TYPED_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "Queue.h"
+
+#if STREAM_WRITE_LIMIT
+    #define __QueueTyped_consumeWriteLimit(QUEUE, LEN)      if (Queue_isWriteLimited(QUEUE)) { (QUEUE)->Buffer.WriteLimit -= (LEN); }
+#else
+    #define __QueueTyped_consumeWriteLimit(QUEUE, LEN)
+#endif
+
+#if STREAM_READ_LIMIT
+    #define __QueueTyped_consumeReadLimit(QUEUE, LEN)       if (Queue_isReadLimited(QUEUE)) { (QUEUE)->Buffer.ReadLimit -= (LEN); }
+#else
+    #define __QueueTyped_consumeReadLimit(QUEUE, LEN)
+#endif
+
+/**
+ * @brief convert raw byte count to item count, divisor is constant so compiler use shift or multiply
+ */
+#define __QueueTyped_items(TYPE, RAW)                       ((Queue_LenType) ((size_t) (RAW) / sizeof(TYPE)))
+
+/**
+ * @brief declare typed queue with fixed capacity
+ *
+ * @param NAME name of struct and prefix of functions
+ * @param TYPE type of items
+ * @param CAP capacity of queue in items, must be power of 2
+ * @note generated functions don't take STREAM_MUTEX, caller must serialize access to shared queue
+ */
+#define QUEUE_DECLARE(NAME, TYPE, CAP) \
+    typedef char NAME##_CapacityMustBePowerOf2[((CAP) > 0 && ((CAP) & ((CAP) - 1)) == 0) ? 1 : -1]; \
+    typedef struct { \
+        Queue           Base; \
+        TYPE            Items[CAP]; \
+    } NAME; \
+    static inline Queue* NAME##_base(NAME* queue) { \
+        return &queue->Base; \
+    } \
+    static inline void NAME##_init(NAME* queue) { \
+        Queue_init(&queue->Base, queue->Items, (Queue_LenType) sizeof(queue->Items), (Queue_LenType) sizeof(TYPE)); \
+    } \
+    static inline void NAME##_deinit(NAME* queue) { \
+        Queue_deinit(&queue->Base); \
+    } \
+    static inline Queue_LenType NAME##_getBufferSize(NAME* queue) { \
+        (void) queue; \
+        return (CAP); \
+    } \
+    static inline Queue_LenType NAME##_available(NAME* queue) { \
+        return __QueueTyped_items(TYPE, Queue_availableRaw(&queue->Base)); \
+    } \
+    static inline Queue_LenType NAME##_space(NAME* queue) { \
+        return __QueueTyped_items(TYPE, Queue_spaceRaw(&queue->Base)); \
+    } \
+    static inline uint8_t NAME##_isEmpty(NAME* queue) { \
+        return Queue_isEmpty(&queue->Base); \
+    } \
+    static inline uint8_t NAME##_isFull(NAME* queue) { \
+        return Queue_isFull(&queue->Base); \
+    } \
+    static inline TYPE* NAME##_getAt(NAME* queue, Queue_LenType index) { \
+        return &queue->Items[(__QueueTyped_items(TYPE, Queue_getReadPosRaw(&queue->Base)) + index) & ((CAP) - 1)]; \
+    } \
+    static inline Queue_Result NAME##_write(NAME* queue, const TYPE* val) { \
+        __Queue_preWrite(&queue->Base, 1); \
+        if (Queue_spaceRaw(&queue->Base) < (Queue_LenType) sizeof(TYPE)) { \
+            return __Queue_writeHook(&queue->Base, Queue_NoSpace, 1); \
+        } \
+        __QueueTyped_consumeWriteLimit(&queue->Base, (Queue_LenType) sizeof(TYPE)) \
+        queue->Items[__QueueTyped_items(TYPE, Queue_getWritePosRaw(&queue->Base))] = *val; \
+        return __Queue_writeHook(&queue->Base, Queue_moveWritePosRaw(&queue->Base, (Queue_LenType) sizeof(TYPE)), 1); \
+    } \
+    static inline Queue_Result NAME##_writeArray(NAME* queue, const TYPE* val, Queue_LenType len) { \
+        Queue_LenType index; \
+        Queue_LenType i; \
+        __Queue_preWrite(&queue->Base, len); \
+        if (Queue_spaceRaw(&queue->Base) < len * (Queue_LenType) sizeof(TYPE)) { \
+            return __Queue_writeHook(&queue->Base, Queue_NoSpace, len); \
+        } \
+        __QueueTyped_consumeWriteLimit(&queue->Base, len * (Queue_LenType) sizeof(TYPE)) \
+        index = __QueueTyped_items(TYPE, Queue_getWritePosRaw(&queue->Base)); \
+        for (i = 0; i < len; i++) { \
+            queue->Items[(index + i) & ((CAP) - 1)] = val[i]; \
+        } \
+        return __Queue_writeHook(&queue->Base, Queue_moveWritePosRaw(&queue->Base, len * (Queue_LenType) sizeof(TYPE)), len); \
+    } \
+    static inline Queue_Result NAME##_read(NAME* queue, TYPE* val) { \
+        __Queue_preRead(&queue->Base, 1); \
+        if (Queue_availableRaw(&queue->Base) < (Queue_LenType) sizeof(TYPE)) { \
+            return __Queue_readHook(&queue->Base, Queue_NoAvailable, 1); \
+        } \
+        __QueueTyped_consumeReadLimit(&queue->Base, (Queue_LenType) sizeof(TYPE)) \
+        *val = queue->Items[__QueueTyped_items(TYPE, Queue_getReadPosRaw(&queue->Base))]; \
+        return __Queue_readHook(&queue->Base, Queue_moveReadPosRaw(&queue->Base, (Queue_LenType) sizeof(TYPE)), 1); \
+    } \
+    static inline Queue_Result NAME##_readArray(NAME* queue, TYPE* val, Queue_LenType len) { \
+        Queue_LenType index; \
+        Queue_LenType i; \
+        __Queue_preRead(&queue->Base, len); \
+        if (Queue_availableRaw(&queue->Base) < len * (Queue_LenType) sizeof(TYPE)) { \
+            return __Queue_readHook(&queue->Base, Queue_NoAvailable, len); \
+        } \
+        __QueueTyped_consumeReadLimit(&queue->Base, len * (Queue_LenType) sizeof(TYPE)) \
+        index = __QueueTyped_items(TYPE, Queue_getReadPosRaw(&queue->Base)); \
+        for (i = 0; i < len; i++) { \
+            val[i] = queue->Items[(index + i) & ((CAP) - 1)]; \
+        } \
+        return __Queue_readHook(&queue->Base, Queue_moveReadPosRaw(&queue->Base, len * (Queue_LenType) sizeof(TYPE)), len); \
+    }
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _QUEUE_TYPED_H_ */
@@ -0,0 +1,136 @@
+#include "Queue.h"
+#include "QueueTest.h"
+
+static Queue queue;
+static uint32_t queueBuffer[16];
+static uint32_t spans;
+static uint32_t nextValue;
+
+static Queue_Result fillSpan(Queue* q, void* val, Queue_LenType index, Queue_LenType count, Queue_LenType len) {
+    uint32_t* items = (uint32_t*) val;
+    Queue_LenType i;
+
+    (void) q;
+    Test_assert(index + count <= len);
+    for (i = 0; i < count; i++) {
+        items[i] = nextValue++;
+    }
+    spans++;
+    return Queue_Ok;
+}
+
+static Queue_Result checkSpan(Queue* q, void* val, Queue_LenType index, Queue_LenType count, Queue_LenType len) {
+    uint32_t* items = (uint32_t*) val;
+    Queue_LenType i;
+
+    (void) q;
+    Test_assert(index + count <= len);
+    for (i = 0; i < count; i++) {
+        Test_assert(items[i] == nextValue++);
+    }
+    spans++;
+    return Queue_Ok;
+}
+
+static Queue_Result rejectSecond(Queue* q, void* val, Queue_LenType index, Queue_LenType count, Queue_LenType len) {
+    (void) q;
+    (void) val;
+    (void) count;
+    (void) len;
+    return index == 0 ? Queue_Ok : Queue_CustomError;
+}
+
+static void testSpans(void) {
+    uint32_t val[10];
+
+    Queue_init(&queue, queueBuffer, sizeof(queueBuffer), sizeof(uint32_t));
+    Test_assert(Queue_writeQueryBatch(&queue, 0, fillSpan) == Queue_ZeroLen);
+    // contiguous batch is one span
+    spans = 0;
+    nextValue = 0;
+    Test_assert(Queue_writeQueryBatch(&queue, 10, fillSpan) == Queue_Ok);
+    Test_assert(spans == 1 && Queue_available(&queue) == 10);
+    // move positions near end of buffer
+    Test_assert(Queue_readArray(&queue, val, 10) == Queue_Ok);
+    Test_assert(val[0] == 0 && val[9] == 9);
+    // batch across wrap around is two spans
+    spans = 0;
+    nextValue = 100;
+    Test_assert(Queue_writeQueryBatch(&queue, 12, fillSpan) == Queue_Ok);
+    Test_assert(spans == 2 && Queue_available(&queue) == 12);
+    spans = 0;
+    nextValue = 100;
+    Test_assert(Queue_readQueryBatch(&queue, 12, checkSpan) == Queue_Ok);
+    Test_assert(spans == 2 && Queue_isEmpty(&queue));
+    // not enough space or items
+    Test_assert(Queue_writeQueryBatch(&queue, 17, fillSpan) == Queue_NoSpace);
+    Test_assert(Queue_readQueryBatch(&queue, 1, checkSpan) == Queue_NoAvailable);
+}
+
+static Queue_Result fillItem(Queue* q, void* item, Queue_LenType index, Queue_LenType len) {
+    (void) q;
+    (void) len;
+    *(uint32_t*) item = nextValue + (uint32_t) index;
+    return Queue_Ok;
+}
+
+static Queue_Result checkItem(Queue* q, void* item, Queue_LenType index, Queue_LenType len) {
+    (void) q;
+    (void) len;
+    Test_assert(*(uint32_t*) item == nextValue + (uint32_t) index);
+    return Queue_Ok;
+}
+
+static void testQueryArray(void) {
+    // every accepted item must be committed, include last one
+    Queue_init(&queue, queueBuffer, sizeof(queueBuffer), sizeof(uint32_t));
+    nextValue = 10;
+    Test_assert(Queue_writeQueryArray(&queue, 1, fillItem) == Queue_Ok);
+    Test_assert(Queue_available(&queue) == 1);
+    Test_assert(Queue_readQueryArray(&queue, 1, checkItem) == Queue_Ok);
+    Test_assert(Queue_isEmpty(&queue));
+    nextValue = 20;
+    Test_assert(Queue_writeQueryArray(&queue, 3, fillItem) == Queue_Ok);
+    Test_assert(Queue_available(&queue) == 3);
+    Test_assert(Queue_readQueryArray(&queue, 3, checkItem) == Queue_Ok);
+    Test_assert(Queue_isEmpty(&queue));
+}
+
+static void testPartial(void) {
+    // query reject second span, only first span committed
+    Queue_init(&queue, queueBuffer, sizeof(queueBuffer), sizeof(uint32_t));
+    nextValue = 0;
+    Test_assert(Queue_writeQueryBatch(&queue, 12, fillSpan) == Queue_Ok);
+    nextValue = 0;
+    Test_assert(Queue_readQueryBatch(&queue, 12, checkSpan) == Queue_Ok);
+    Test_assert(Queue_writeQueryBatch(&queue, 8, rejectSecond) == Queue_CustomError);
+    Test_assert(Queue_available(&queue) == 4);
+    Test_assert(Queue_readQueryBatch(&queue, 4, rejectSecond) == Queue_Ok);
+    Test_assert(Queue_isEmpty(&queue));
+}
+
+static void testMovePos(void) {
+    uint32_t vals[3] = { 7, 8, 9 };
+    uint32_t val;
+    Queue_LenType steps = 1;
+
+    // moveWritePos publish items written through write pointer, moveReadPos drop them
+    Queue_init(&queue, queueBuffer, sizeof(queueBuffer), sizeof(uint32_t));
+    *(uint32_t*) Queue_getWritePtr(&queue) = vals[0];
+    Test_assert(Queue_moveWritePos(&queue, 1) == Queue_Ok);
+    Test_assert(Queue_available(&queue) == 1);
+    Test_assert(Queue_writeArray(&queue, &vals[1], 2) == Queue_Ok);
+    // steps expression must be scaled as a whole
+    Test_assert(Queue_moveReadPos(&queue, steps + 1) == Queue_Ok);
+    Test_assert(Queue_available(&queue) == 1);
+    Test_assert(Queue_read(&queue, &val) == Queue_Ok && val == 9);
+    Test_assert(Queue_isEmpty(&queue));
+}
+
+int main(void) {
+    Test_run(testSpans);
+    Test_run(testQueryArray);
+    Test_run(testPartial);
+    Test_run(testMovePos);
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "QueueBroadcast.h"
+#include "QueueTest.h"
+
+#define ITEMS           100000
+#define READERS         3
+
+typedef struct {
+    uint32_t    Seq;
+    uint32_t    Check;
+} Item;
+
+typedef struct {
+    Queue_LenType   Index;
+    uint32_t        Received;
+    uint8_t         Lost;
+} ReaderState;
+
+static QueueBroadcast queue;
+static Item queueBuffer[16];
+static volatile int writerDone;
+static uint32_t writerBurst;
+
+static void testInit(void) {
+    Item item = {0, 0};
+
+    Test_assert(QueueBroadcast_init(&queue, queueBuffer, sizeof(Item) - 1, sizeof(Item), QueueBroadcast_LagBlock) == Queue_NoSpace);
+    Test_assert(QueueBroadcast_getBufferSize(&queue) == 0);
+    Test_assert(QueueBroadcast_space(&queue) == 0);
+    Test_assert(QueueBroadcast_write(&queue, &item) == Queue_NoSpace);
+    Test_assert(QueueBroadcast_init(&queue, NULL, sizeof(queueBuffer), sizeof(Item), QueueBroadcast_LagBlock) == Queue_NoSpace);
+    // one item is enough, rest rounded down to power of 2
+    Test_assert(QueueBroadcast_init(&queue, queueBuffer, sizeof(Item), sizeof(Item), QueueBroadcast_LagBlock) == Queue_Ok);
+    Test_assert(QueueBroadcast_getBufferSize(&queue) == 1);
+    Test_assert(QueueBroadcast_init(&queue, queueBuffer, 15 * sizeof(Item), sizeof(Item), QueueBroadcast_LagBlock) == Queue_Ok);
+    Test_assert(QueueBroadcast_getBufferSize(&queue) == 8);
+    QueueBroadcast_deinit(&queue);
+}
+
+static void* writer(void* arg) {
+    Item item;
+    uint32_t i;
+
+    (void) arg;
+    for (i = 0; i < ITEMS; i++) {
+        item.Seq = i;
+        item.Check = ~i;
+        while (QueueBroadcast_write(&queue, &item) != Queue_Ok) {
+            Test_yield();
+        }
+        // longer burst than buffer make readers lag
+        if (i % writerBurst == 0) {
+            Test_yield();
+        }
+    }
+    writerDone = 1;
+    return NULL;
+}
+
+static void* reader(void* arg) {
+    ReaderState* state = (ReaderState*) arg;
+    Item item[2];
+    Queue_Result res;
+    Queue_LenType len;
+    Queue_LenType i;
+    int64_t last = -1;
+    uint8_t done = 0;
+
+    while (!done) {
+        done = writerDone;
+        // mix single and array reads
+        len = (state->Received & 1) != 0 && QueueBroadcast_available(&queue, state->Index) >= 2 ? 2 : 1;
+        res = QueueBroadcast_readArray(&queue, state->Index, item, len);
+        if (res == Queue_Ok) {
+            for (i = 0; i < len; i++) {
+                Test_assert(item[i].Check == ~item[i].Seq);
+                Test_assert((int64_t) item[i].Seq > last);
+                if (queue.LagPolicy != QueueBroadcast_LagSkip || i > 0) {
+                    Test_assert((int64_t) item[i].Seq == last + 1);
+                }
+                last = item[i].Seq;
+            }
+            state->Received += (uint32_t) len;
+            done = 0;
+        }
+        else if (res == QueueBroadcast_Lost) {
+            Test_assert(queue.LagPolicy == QueueBroadcast_LagDetach);
+            state->Lost = 1;
+            return NULL;
+        }
+        else {
+            Test_assert(res == Queue_NoAvailable);
+            Test_yield();
+        }
+    }
+    return NULL;
+}
+
+static void runPolicy(QueueBroadcast_LagPolicy policy) {
+    pthread_t threads[READERS + 1];
+    ReaderState states[READERS];
+    int i;
+
+    Test_assert(QueueBroadcast_init(&queue, queueBuffer, sizeof(queueBuffer), sizeof(Item), policy) == Queue_Ok);
+    writerDone = 0;
+    writerBurst = policy == QueueBroadcast_LagBlock ? 8 : 64;
+    for (i = 0; i < READERS; i++) {
+        states[i].Index = QueueBroadcast_addReader(&queue);
+        states[i].Received = 0;
+        states[i].Lost = 0;
+        Test_assert(states[i].Index >= 0);
+        Test_assert(pthread_create(&threads[i], NULL, reader, &states[i]) == 0);
+    }
+    Test_assert(pthread_create(&threads[READERS], NULL, writer, NULL) == 0);
+    for (i = 0; i <= READERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    for (i = 0; i < READERS; i++) {
+        switch (policy) {
+            case QueueBroadcast_LagBlock:
+                Test_assert(states[i].Received == ITEMS);
+                break;
+            case QueueBroadcast_LagSkip:
+                Test_assert(states[i].Received + QueueBroadcast_getSkipped(&queue, states[i].Index) == ITEMS);
+                break;
+            default:
+                Test_assert(states[i].Lost || states[i].Received == ITEMS);
+                Test_assert(states[i].Lost == (QueueBroadcast_getReaderState(&queue, states[i].Index) == QueueBroadcast_ReaderDetached));
+                break;
+        }
+        printf("reader %d: received %u, skipped %u, lost %u\n", i, states[i].Received,
+               QueueBroadcast_getSkipped(&queue, states[i].Index), states[i].Lost);
+    }
+    QueueBroadcast_deinit(&queue);
+}
+
+static void testBlock(void) {
+    runPolicy(QueueBroadcast_LagBlock);
+}
+
+static void testSkip(void) {
+    runPolicy(QueueBroadcast_LagSkip);
+}
+
+static void testDetach(void) {
+    runPolicy(QueueBroadcast_LagDetach);
+}
+
+int main(void) {
+    Test_run(testInit);
+    Test_run(testBlock);
+    Test_run(testSkip);
+    Test_run(testDetach);
+    return 0;
+}
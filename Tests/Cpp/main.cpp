@@ -0,0 +1,137 @@
+#include "Queue.hpp"
+#include "QueueMapped.h"
+#include "QueueTest.h"
+
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+int liveItems = 0;
+int copiesBeforeThrow = -1;
+
+struct Tracked {
+    std::string     Name;
+
+    explicit Tracked(const char* name) : Name(name) { ++liveItems; }
+    Tracked(const Tracked& other) : Name(other.Name) {
+        if (copiesBeforeThrow == 0) {
+            throw 1;
+        }
+        if (copiesBeforeThrow > 0) {
+            --copiesBeforeThrow;
+        }
+        ++liveItems;
+    }
+    Tracked(Tracked&& other) noexcept : Name(std::move(other.Name)) { ++liveItems; }
+    Tracked& operator=(const Tracked& other) = default;
+    Tracked& operator=(Tracked&& other) noexcept = default;
+    ~Tracked() { --liveItems; }
+};
+
+void testBasic() {
+    queue::Queue<Tracked, 4> q;
+    std::vector<Tracked> out;
+
+    Test_assert(q.empty() && q.capacity() == 4);
+    Test_assert(q.emplace("a"));
+    Test_assert(q.push(Tracked("b")));
+    Test_assert(q.size() == 2 && q.front().Name == "a");
+    Test_assert(q.pop());
+    Test_assert(q.front().Name == "b");
+    Test_assert(q.emplace("c") && q.emplace("d") && q.emplace("e"));
+    Test_assert(q.full() && !q.emplace("f"));
+    Tracked item("x");
+    Test_assert(q.pop(item) && item.Name == "b");
+    Test_assert(q.pop_range(std::back_inserter(out), 8) == 3);
+    Test_assert(out.size() == 3 && out[0].Name == "c" && out[2].Name == "e");
+    Test_assert(q.empty());
+}
+
+void testPushRangeThrow() {
+    const Tracked src[3] = {Tracked("a"), Tracked("b"), Tracked("c")};
+    int live;
+    {
+        queue::Queue<Tracked, 8> q;
+        Test_assert(q.emplace("first"));
+        live = liveItems;
+        // third copy throw, two staged copies must be destroyed and queue unchanged
+        copiesBeforeThrow = 2;
+        bool thrown = false;
+        try {
+            q.push_range(src, src + 3);
+        }
+        catch (int) {
+            thrown = true;
+        }
+        copiesBeforeThrow = -1;
+        Test_assert(thrown);
+        Test_assert(liveItems == live);
+        Test_assert(q.size() == 1 && q.front().Name == "first");
+        // queue still usable after failure
+        Test_assert(q.push_range(src, src + 3) == 3);
+        Test_assert(q.size() == 4);
+    }
+    // destructor of queue destroy remaining items
+    Test_assert(liveItems == 3);
+}
+
+struct ThrowingOutput {
+    std::vector<std::string>*   Names;
+    int                         Limit;
+
+    ThrowingOutput& operator*() { return *this; }
+    ThrowingOutput& operator++() { return *this; }
+    ThrowingOutput& operator=(Tracked&& item) {
+        if (Limit-- == 0) {
+            throw 2;
+        }
+        Names->push_back(item.Name);
+        return *this;
+    }
+};
+
+void testPopRangeThrow() {
+    queue::Queue<Tracked, 4> q;
+    std::vector<std::string> names;
+    ThrowingOutput out = {&names, 2};
+    bool thrown = false;
+
+    Test_assert(q.emplace("a") && q.emplace("b") && q.emplace("c"));
+    try {
+        q.pop_range(out, 3);
+    }
+    catch (int) {
+        thrown = true;
+    }
+    // items moved out before throw are removed, rest stay in queue
+    Test_assert(thrown);
+    Test_assert(names.size() == 2);
+    Test_assert(q.size() == 1 && q.front().Name == "c");
+}
+
+void testCHeaders() {
+    // C headers must compile as C++
+    QueueMapped mapped;
+    uint32_t val = 3;
+
+    Test_assert(Queue_openMapped(&mapped, "/tmp/queue-cpp-mapped.bin", 4, sizeof(val)) == Queue_Ok);
+    Queue_reset(&mapped.Base);
+    Test_assert(Queue_writeMapped(&mapped, &val) == Queue_Ok);
+    val = 0;
+    Test_assert(Queue_readMapped(&mapped, &val) == Queue_Ok && val == 3);
+    Queue_closeMapped(&mapped);
+    unlink("/tmp/queue-cpp-mapped.bin");
+}
+
+} // namespace
+
+int main() {
+    Test_run(testBasic);
+    Test_run(testPushRangeThrow);
+    Test_run(testPopRangeThrow);
+    Test_run(testCHeaders);
+    Test_assert(liveItems == 0);
+    return 0;
+}
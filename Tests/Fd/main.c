@@ -0,0 +1,114 @@
+#include "Queue.h"
+#include "QueueTest.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+static Queue queue;
+static uint64_t queueBuffer[1024];
+static int fds[2];
+
+static void openPipe(void) {
+    Test_assert(pipe(fds) == 0);
+    Test_assert(fcntl(fds[0], F_SETFL, O_NONBLOCK) == 0);
+    Test_assert(fcntl(fds[1], F_SETFL, O_NONBLOCK) == 0);
+}
+
+static void closePipe(void) {
+    close(fds[0]);
+    close(fds[1]);
+}
+
+static void testPartialItem(void) {
+    const char* data = "AAAAAAAABBBBBBBBCCCCCCCCDDDDDDDD";
+    char item[8];
+
+    openPipe();
+    Queue_init(&queue, queueBuffer, 4 * sizeof(uint64_t), sizeof(uint64_t));
+    // move write position near end of buffer, readv must split
+    Test_assert(Queue_writeArray(&queue, queueBuffer, 3) == Queue_Ok);
+    Test_assert(Queue_readArray(&queue, queueBuffer, 3) == Queue_Ok);
+    Test_assert(write(fds[1], data, 12) == 12);
+    Test_assert(Queue_writeFromFd(&queue, fds[0], 4) == 1);
+    Test_assert(Queue_writeFromFd(&queue, fds[0], 4) == 0);
+    Test_assert(write(fds[1], data + 12, 20) == 20);
+    Test_assert(Queue_writeFromFd(&queue, fds[0], 4) == 3);
+    Test_assert(Queue_read(&queue, item) == Queue_Ok && memcmp(item, "AAAAAAAA", 8) == 0);
+    Test_assert(Queue_read(&queue, item) == Queue_Ok && memcmp(item, "BBBBBBBB", 8) == 0);
+    Test_assert(Queue_read(&queue, item) == Queue_Ok && memcmp(item, "CCCCCCCC", 8) == 0);
+    Test_assert(Queue_read(&queue, item) == Queue_Ok && memcmp(item, "DDDDDDDD", 8) == 0);
+    // end of file is not an error
+    close(fds[1]);
+    Test_assert(Queue_writeFromFd(&queue, fds[0], 4) == QUEUE_FD_EOF);
+    close(fds[0]);
+}
+
+static void testInterleavedWrite(void) {
+    char item[8];
+
+    openPipe();
+    Queue_init(&queue, queueBuffer, 4 * sizeof(uint64_t), sizeof(uint64_t));
+    Test_assert(write(fds[1], "xxxx", 4) == 4);
+    Test_assert(Queue_writeFromFd(&queue, fds[0], 4) == 0);
+    // ordinary write overwrite incomplete item, it must not be completed with stale bytes
+    Test_assert(Queue_write(&queue, "WWWWWWWW") == Queue_Ok);
+    Test_assert(write(fds[1], "EEEEEEEE", 8) == 8);
+    Test_assert(Queue_writeFromFd(&queue, fds[0], 4) == 1);
+    Test_assert(Queue_read(&queue, item) == Queue_Ok && memcmp(item, "WWWWWWWW", 8) == 0);
+    Test_assert(Queue_read(&queue, item) == Queue_Ok && memcmp(item, "EEEEEEEE", 8) == 0);
+    Test_assert(Queue_isEmpty(&queue));
+    closePipe();
+}
+
+static void testInterleavedRead(void) {
+    static uint8_t buffer[1024 * 12];
+    char buf[4096];
+    char item[12];
+    uint32_t i;
+
+    openPipe();
+    Test_assert(fcntl(fds[1], F_SETPIPE_SZ, 4096) == 4096);
+    // 12-byte items don't divide pipe size, so last item sent partially
+    Queue_init(&queue, buffer, sizeof(buffer), sizeof(item));
+    for (i = 0; i < 1024; i++) {
+        memset(item, 'a' + i % 26, sizeof(item));
+        Test_assert(Queue_write(&queue, item) == Queue_Ok);
+    }
+    Test_assert(Queue_readToFd(&queue, fds[1], 1024) == 4096 / 12);
+    Test_assert(Queue_readToFd(&queue, fds[1], 1024) == 0);
+    Test_assert(read(fds[0], buf, sizeof(buf)) == 4096);
+    // item that partially sent removed by ordinary read
+    Test_assert(Queue_read(&queue, item) == Queue_Ok && item[0] == 'a' + (4096 / 12) % 26);
+    // next item sent from its beginning
+    Test_assert(Queue_readToFd(&queue, fds[1], 1) == 1);
+    Test_assert(read(fds[0], buf, sizeof(buf)) == 12);
+    memset(item, 'a' + (4096 / 12 + 1) % 26, sizeof(item));
+    Test_assert(memcmp(buf, item, sizeof(item)) == 0);
+    closePipe();
+}
+
+static void testLargeMaxItems(void) {
+    // maxItems * ItemSize overflow, must be clamped to free space and available items
+    const Queue_LenType maxItems = (Queue_LenType) (((uint32_t) 1 << (sizeof(Queue_LenType) * 8 - 1)) / sizeof(uint64_t));
+    char buf[32];
+
+    openPipe();
+    Queue_init(&queue, queueBuffer, 4 * sizeof(uint64_t), sizeof(uint64_t));
+    Test_assert(write(fds[1], "AAAAAAAABBBBBBBB", 16) == 16);
+    Test_assert(Queue_writeFromFd(&queue, fds[0], maxItems) == 2);
+    Test_assert(Queue_writeFromFd(&queue, fds[0], 0) == 0);
+    Test_assert(Queue_readToFd(&queue, fds[1], 0) == 0);
+    Test_assert(Queue_readToFd(&queue, fds[1], maxItems) == 2);
+    Test_assert(read(fds[0], buf, sizeof(buf)) == 16 && memcmp(buf, "AAAAAAAABBBBBBBB", 16) == 0);
+    Test_assert(Queue_isEmpty(&queue));
+    closePipe();
+}
+
+int main(void) {
+    Test_run(testPartialItem);
+    Test_run(testInterleavedWrite);
+    Test_run(testInterleavedRead);
+    Test_run(testLargeMaxItems);
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include "QueueGroup.h"
+#include "QueueTest.h"
+
+#include <string.h>
+
+#define SHARDS          4
+#define PRODUCERS       4
+#define CONSUMERS       3
+#define ITEMS           50000
+#define SHARD_ITEMS     64
+
+typedef struct {
+    uint32_t    Producer;
+    uint32_t    Seq;
+} Item;
+
+static QueueGroup group;
+static QueueMPMC shards[SHARDS];
+static uint8_t buffer[SHARDS * QueueMPMC_bufferSize(SHARD_ITEMS, sizeof(Item))] __attribute__((aligned(QUEUE_MPMC_CELL_ALIGN)));
+static uint8_t seen[PRODUCERS][ITEMS];
+static volatile uint32_t consumed;
+static volatile int producersDone;
+
+static void testInit(void) {
+    Item item = {1, 2};
+
+    Test_assert(QueueGroup_init(&group, shards, 0, buffer, sizeof(buffer), sizeof(Item)) == Queue_NoSpace);
+    Test_assert(QueueGroup_getShardCount(&group) == 0);
+    Test_assert(QueueGroup_getShard(&group, 1) == NULL);
+    Test_assert(QueueGroup_read(&group, 0, &item) == Queue_NoAvailable);
+    Test_assert(QueueGroup_write(&group, 1, &item) == Queue_NoSpace);
+    Test_assert(QueueGroup_writeArray(&group, 1, &item, 1) == Queue_NoSpace);
+    Test_assert(QueueGroup_writeKey(&group, 7, &item) == Queue_NoSpace);
+    // last shard is too small
+    Test_assert(QueueGroup_init(&group, shards, SHARDS, buffer, QueueMPMC_cellSize(sizeof(Item)) - 1, sizeof(Item)) == Queue_NoSpace);
+    Test_assert(QueueGroup_getShardCount(&group) == 0);
+    Test_assert(QueueGroup_write(&group, 1, &item) == Queue_NoSpace);
+
+    Test_assert(QueueGroup_init(&group, shards, SHARDS, buffer, QueueMPMC_bufferSize(SHARD_ITEMS, sizeof(Item)), sizeof(Item)) == Queue_Ok);
+    Test_assert(QueueGroup_space(&group) == SHARDS * SHARD_ITEMS);
+    // consumer steal from other shards when home is empty
+    Test_assert(QueueGroup_write(&group, 2, &item) == Queue_Ok);
+    Test_assert(QueueGroup_available(&group) == 1);
+    memset(&item, 0, sizeof(item));
+    Test_assert(QueueGroup_read(&group, 0, &item) == Queue_Ok && item.Producer == 1 && item.Seq == 2);
+    Test_assert(QueueGroup_read(&group, 0, &item) == Queue_NoAvailable);
+    // same key always go to same shard
+    Test_assert(QueueGroup_writeKey(&group, 6, &item) == Queue_Ok);
+    Test_assert(QueueMPMC_available(QueueGroup_getShard(&group, 2)) == 1);
+    QueueGroup_deinit(&group);
+}
+
+static void* producer(void* arg) {
+    uint32_t id = (uint32_t) (uintptr_t) arg;
+    Item item;
+    uint32_t i;
+
+    item.Producer = id;
+    for (i = 0; i < ITEMS; i++) {
+        item.Seq = i;
+        while (QueueGroup_write(&group, id, &item) != Queue_Ok) {
+            Test_yield();
+        }
+    }
+    return NULL;
+}
+
+static void* consumer(void* arg) {
+    Queue_LenType home = (Queue_LenType) (uintptr_t) arg;
+    int64_t last[PRODUCERS];
+    Item item[4];
+    Queue_LenType len;
+    Queue_LenType i;
+    uint8_t done = 0;
+
+    for (i = 0; i < PRODUCERS; i++) {
+        last[i] = -1;
+    }
+    while (!done) {
+        done = producersDone;
+        len = QueueGroup_readArray(&group, home, item, 1 + (consumed & 3));
+        if (len == 0) {
+            Test_yield();
+            continue;
+        }
+        done = 0;
+        for (i = 0; i < len; i++) {
+            Test_assert(item[i].Producer < PRODUCERS && item[i].Seq < ITEMS);
+            // one shard per producer, so each consumer see items of a producer in order
+            Test_assert((int64_t) item[i].Seq > last[item[i].Producer]);
+            last[item[i].Producer] = item[i].Seq;
+            Test_assert(__atomic_exchange_n(&seen[item[i].Producer][item[i].Seq], 1, __ATOMIC_RELAXED) == 0);
+        }
+        __atomic_fetch_add(&consumed, (uint32_t) len, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+static void testStress(void) {
+    pthread_t producers[PRODUCERS];
+    pthread_t consumers[CONSUMERS];
+    uintptr_t i;
+
+    Test_assert(QueueGroup_init(&group, shards, SHARDS, buffer, QueueMPMC_bufferSize(SHARD_ITEMS, sizeof(Item)), sizeof(Item)) == Queue_Ok);
+    for (i = 0; i < CONSUMERS; i++) {
+        Test_assert(pthread_create(&consumers[i], NULL, consumer, (void*) i) == 0);
+    }
+    for (i = 0; i < PRODUCERS; i++) {
+        Test_assert(pthread_create(&producers[i], NULL, producer, (void*) i) == 0);
+    }
+    for (i = 0; i < PRODUCERS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    producersDone = 1;
+    for (i = 0; i < CONSUMERS; i++) {
+        pthread_join(consumers[i], NULL);
+    }
+    Test_assert(consumed == PRODUCERS * ITEMS);
+    Test_assert(QueueGroup_available(&group) == 0);
+    QueueGroup_deinit(&group);
+}
+
+int main(void) {
+    Test_run(testInit);
+    Test_run(testStress);
+    return 0;
+}
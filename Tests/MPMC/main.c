@@ -0,0 +1,128 @@
+#include "QueueMPMC.h"
+#include "QueueTest.h"
+
+#define PRODUCERS       4
+#define CONSUMERS       4
+#define ITEMS           50000
+
+static QueueMPMC mpmc;
+static uint64_t mpmcBuffer[QueueMPMC_bufferSize(64, sizeof(uint32_t)) / sizeof(uint64_t)];
+static uint8_t received[PRODUCERS][ITEMS];
+static uint32_t consumed;
+
+static void testBasic(void) {
+    uint32_t val[4] = {1, 2, 3, 4};
+    uint32_t out[4];
+    uint32_t i;
+
+    // buffer smaller than one cell, queue has zero capacity
+    Test_assert(QueueMPMC_init(&mpmc, mpmcBuffer, QueueMPMC_cellSize(sizeof(uint32_t)) - 1, sizeof(uint32_t)) == Queue_NoSpace);
+    Test_assert(QueueMPMC_getBufferSize(&mpmc) == 0);
+    Test_assert(QueueMPMC_space(&mpmc) == 0);
+    Test_assert(QueueMPMC_write(&mpmc, val) == Queue_NoSpace);
+    Test_assert(QueueMPMC_read(&mpmc, out) == Queue_NoAvailable);
+    // number of cells rounded down to power of 2
+    Test_assert(QueueMPMC_init(&mpmc, mpmcBuffer, QueueMPMC_bufferSize(3, sizeof(uint32_t)), sizeof(uint32_t)) == Queue_Ok);
+    Test_assert(QueueMPMC_getBufferSize(&mpmc) == 2);
+    Test_assert(QueueMPMC_init(&mpmc, mpmcBuffer, sizeof(mpmcBuffer), sizeof(uint32_t)) == Queue_Ok);
+    Test_assert(QueueMPMC_getBufferSize(&mpmc) == 64);
+    Test_assert(QueueMPMC_writeArray(&mpmc, val, 0) == Queue_ZeroLen);
+    for (i = 0; i < 16; i++) {
+        Test_assert(QueueMPMC_writeArray(&mpmc, val, 4) == Queue_Ok);
+    }
+    Test_assert(QueueMPMC_isFull(&mpmc));
+    Test_assert(QueueMPMC_write(&mpmc, val) == Queue_NoSpace);
+    for (i = 0; i < 16; i++) {
+        Test_assert(QueueMPMC_readArray(&mpmc, out, 4) == Queue_Ok);
+        Test_assert(out[0] == 1 && out[3] == 4);
+    }
+    Test_assert(QueueMPMC_isEmpty(&mpmc));
+    Test_assert(QueueMPMC_readArray(&mpmc, out, 65) == Queue_NoAvailable);
+    QueueMPMC_deinit(&mpmc);
+}
+
+static void* producer(void* arg) {
+    uint32_t id = (uint32_t) (uintptr_t) arg;
+    uint32_t val[3];
+    uint32_t seq = 0;
+    uint32_t len;
+    uint32_t i;
+
+    while (seq < ITEMS) {
+        len = 1 + seq % 3;
+        if (len > ITEMS - seq) {
+            len = ITEMS - seq;
+        }
+        for (i = 0; i < len; i++) {
+            val[i] = (id << 24) | (seq + i);
+        }
+        if (QueueMPMC_writeArray(&mpmc, val, (Queue_LenType) len) == Queue_Ok) {
+            seq += len;
+        }
+        else {
+            Test_yield();
+        }
+    }
+    return NULL;
+}
+
+static void* consumer(void* arg) {
+    uint32_t last[PRODUCERS];
+    uint32_t val;
+    uint32_t id;
+    uint32_t seq;
+
+    (void) arg;
+    for (id = 0; id < PRODUCERS; id++) {
+        last[id] = 0;
+    }
+    while (__atomic_load_n(&consumed, __ATOMIC_RELAXED) < PRODUCERS * ITEMS) {
+        if (QueueMPMC_read(&mpmc, &val) != Queue_Ok) {
+            Test_yield();
+            continue;
+        }
+        id = val >> 24;
+        seq = val & 0xFFFFFF;
+        Test_assert(id < PRODUCERS && seq < ITEMS);
+        // items of one producer are dequeued in order
+        Test_assert(seq + 1 > last[id]);
+        last[id] = seq + 1;
+        __atomic_add_fetch(&received[id][seq], 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&consumed, 1, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+static void testStress(void) {
+    pthread_t producers[PRODUCERS];
+    pthread_t consumers[CONSUMERS];
+    uint32_t i;
+    uint32_t j;
+
+    Test_assert(QueueMPMC_init(&mpmc, mpmcBuffer, sizeof(mpmcBuffer), sizeof(uint32_t)) == Queue_Ok);
+    for (i = 0; i < CONSUMERS; i++) {
+        Test_assert(pthread_create(&consumers[i], NULL, consumer, NULL) == 0);
+    }
+    for (i = 0; i < PRODUCERS; i++) {
+        Test_assert(pthread_create(&producers[i], NULL, producer, (void*) (uintptr_t) i) == 0);
+    }
+    for (i = 0; i < PRODUCERS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    for (i = 0; i < CONSUMERS; i++) {
+        pthread_join(consumers[i], NULL);
+    }
+    // every item received exactly once
+    for (i = 0; i < PRODUCERS; i++) {
+        for (j = 0; j < ITEMS; j++) {
+            Test_assert(received[i][j] == 1);
+        }
+    }
+    Test_assert(QueueMPMC_isEmpty(&mpmc));
+}
+
+int main(void) {
+    Test_run(testBasic);
+    Test_run(testStress);
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "QueueMapped.h"
+#include "QueueTest.h"
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static char path[64];
+
+static void crashWriter(void) {
+    QueueMapped mapped;
+    uint32_t val;
+
+    if (Queue_openMapped(&mapped, path, 64, sizeof(uint32_t)) != Queue_Ok) {
+        _exit(2);
+    }
+    // committed items
+    for (val = 0; val < 10; val++) {
+        if (Queue_writeMapped(&mapped, &val) != Queue_Ok) {
+            _exit(3);
+        }
+    }
+    val = 0;
+    if (Queue_readMapped(&mapped, &val) != Queue_Ok || val != 0) {
+        _exit(4);
+    }
+    // not committed, lost on crash
+    for (val = 100; val < 105; val++) {
+        (void) Queue_write(&mapped.Base, &val);
+    }
+    // exit without close, like a crash
+    _exit(0);
+}
+
+static void testCrashRecovery(void) {
+    QueueMapped mapped;
+    pid_t pid;
+    int status;
+    uint32_t val;
+    uint32_t i;
+
+    pid = fork();
+    Test_assert(pid >= 0);
+    if (pid == 0) {
+        crashWriter();
+    }
+    Test_assert(waitpid(pid, &status, 0) == pid);
+    Test_assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    Test_assert(Queue_openMapped(&mapped, path, 64, sizeof(uint32_t)) == Queue_Ok);
+    Test_assert(Queue_available(&mapped.Base) == 9);
+    for (i = 1; i < 10; i++) {
+        Test_assert(Queue_readMapped(&mapped, &val) == Queue_Ok && val == i);
+    }
+    Test_assert(Queue_isEmpty(&mapped.Base));
+    // batch commit survive close and reopen
+    for (val = 20; val < 25; val++) {
+        Test_assert(Queue_write(&mapped.Base, &val) == Queue_Ok);
+    }
+    Test_assert(Queue_commitMapped(&mapped) == Queue_Ok);
+    Queue_closeMapped(&mapped);
+
+    Test_assert(Queue_openMapped(&mapped, path, 64, sizeof(uint32_t)) == Queue_Ok);
+    Test_assert(Queue_available(&mapped.Base) == 5);
+    Test_assert(Queue_read(&mapped.Base, &val) == Queue_Ok && val == 20);
+    Queue_closeMapped(&mapped);
+}
+
+static void testTornCommit(void) {
+    QueueMapped mapped;
+    QueueMapped_Commit* last;
+    uint32_t val = 1;
+
+    Test_assert(Queue_openMapped(&mapped, path, 64, sizeof(uint32_t)) == Queue_Ok);
+    Queue_setMappedSync(&mapped, Queue_SyncItem, 0);
+    Queue_reset(&mapped.Base);
+    Test_assert(Queue_commitMapped(&mapped) == Queue_Ok);
+    Test_assert(Queue_writeMapped(&mapped, &val) == Queue_Ok);
+    val = 2;
+    Test_assert(Queue_writeMapped(&mapped, &val) == Queue_Ok);
+    // corrupt last commit, previous one must be restored
+    last = &mapped.Header->Commits[mapped.Generation & 1];
+    last->Checksum ^= 0x1;
+    munmap(mapped.Header, mapped.MapSize);
+    close(mapped.Fd);
+
+    Test_assert(Queue_openMapped(&mapped, path, 64, sizeof(uint32_t)) == Queue_Ok);
+    Test_assert(Queue_available(&mapped.Base) == 1);
+    Test_assert(Queue_read(&mapped.Base, &val) == Queue_Ok && val == 1);
+    Queue_closeMapped(&mapped);
+    // different geometry start empty queue
+    Test_assert(Queue_openMapped(&mapped, path, 64, sizeof(uint64_t)) == Queue_Ok);
+    Test_assert(Queue_isEmpty(&mapped.Base));
+    Queue_closeMapped(&mapped);
+}
+
+static void testItemAligned(void) {
+    QueueMapped mapped;
+    uint8_t item[12] = {0};
+    Queue_LenType i;
+
+    // 12-byte items don't divide page size, capacity must still be whole items
+    Test_assert(Queue_openMapped(&mapped, path, 5, sizeof(item)) == Queue_Ok);
+    Test_assert(Queue_getBufferSizeRaw(&mapped.Base) % sizeof(item) == 0);
+    Test_assert(Queue_getBufferSizeRaw(&mapped.Base) % sysconf(_SC_PAGESIZE) == 0);
+    Queue_reset(&mapped.Base);
+    for (i = 0; i < Queue_getBufferSize(&mapped.Base); i++) {
+        Test_assert(Queue_write(&mapped.Base, item) == Queue_Ok);
+    }
+    Test_assert(Queue_spaceRaw(&mapped.Base) == 0);
+    Queue_closeMapped(&mapped);
+
+    Test_assert(Queue_openMapped(&mapped, path, 5, 0) == Queue_CustomError);
+    Test_assert(Queue_openMapped(&mapped, path, 0, sizeof(item)) == Queue_CustomError);
+}
+
+int main(void) {
+    snprintf(path, sizeof(path), "/tmp/queue-mapped-%d.bin", (int) getpid());
+    unlink(path);
+    Test_run(testCrashRecovery);
+    Test_run(testTornCommit);
+    Test_run(testItemAligned);
+    unlink(path);
+    return 0;
+}
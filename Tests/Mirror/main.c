@@ -0,0 +1,56 @@
+#include "Queue.h"
+#include "QueueTest.h"
+
+#include <unistd.h>
+
+typedef struct {
+    uint32_t    Seq;
+    uint32_t    Check;
+    uint32_t    Pad;
+} Item;
+
+static Queue queue;
+
+static void testItemAligned(void) {
+    Item item[16];
+    Item* ptr;
+    uint32_t seq = 0;
+    uint32_t i;
+
+    // 12-byte items don't divide page size, capacity must still be whole items
+    Test_assert(Queue_initMirrored(&queue, 5, sizeof(Item)) == Queue_Ok);
+    Test_assert(Queue_getBufferSizeRaw(&queue) % sizeof(Item) == 0);
+    Test_assert(Queue_getBufferSizeRaw(&queue) % sysconf(_SC_PAGESIZE) == 0);
+    Test_assert(Queue_getBufferSize(&queue) >= 5);
+    // move positions close to end of buffer
+    for (i = 0; i + 4 < (uint32_t) Queue_getBufferSize(&queue); i++) {
+        item[0].Seq = seq++;
+        Test_assert(Queue_write(&queue, &item[0]) == Queue_Ok);
+        Test_assert(Queue_read(&queue, &item[0]) == Queue_Ok);
+    }
+    // span across wrap around is contiguous in mirrored view
+    for (i = 0; i < 16; i++) {
+        item[i].Seq = seq + i;
+        item[i].Check = ~(seq + i);
+    }
+    Test_assert(Queue_writeArray(&queue, item, 16) == Queue_Ok);
+    Test_assert(Queue_directAvailable(&queue) == 16);
+    ptr = (Item*) Queue_getReadPtr(&queue);
+    for (i = 0; i < 16; i++) {
+        Test_assert(ptr[i].Seq == seq + i && ptr[i].Check == ~(seq + i));
+    }
+    Test_assert(Queue_readArray(&queue, item, 16) == Queue_Ok);
+    Test_assert(item[15].Seq == seq + 15);
+    Queue_deinitMirrored(&queue);
+}
+
+static void testInvalid(void) {
+    Test_assert(Queue_initMirrored(&queue, 0, sizeof(Item)) == Queue_CustomError);
+    Test_assert(Queue_initMirrored(&queue, 4, 0) == Queue_CustomError);
+}
+
+int main(void) {
+    Test_run(testItemAligned);
+    Test_run(testInvalid);
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "Queue.h"
+#include "QueueTest.h"
+
+#define ITEMS           200000
+
+typedef struct {
+    uint32_t    Seq;
+    uint32_t    Check;
+} Item;
+
+static Queue queue;
+static Item queueBuffer[8];
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static volatile int producerDone;
+
+static void testDropOldest(void) {
+    Item item;
+    uint32_t i;
+
+    Queue_initOverwrite(&queue, queueBuffer, sizeof(queueBuffer), sizeof(Item));
+    for (i = 0; i < 12; i++) {
+        item.Seq = i;
+        Test_assert(Queue_write(&queue, &item) == Queue_Ok);
+    }
+    Test_assert(Queue_getDropped(&queue) == 4);
+    Test_assert(Queue_available(&queue) == 8);
+    for (i = 4; i < 12; i++) {
+        Test_assert(Queue_read(&queue, &item) == Queue_Ok && item.Seq == i);
+    }
+    // larger than buffer can't be written
+    Test_assert(Queue_writeArray(&queue, queueBuffer, 9) == Queue_NoSpace);
+}
+
+static void* producer(void* arg) {
+    Item item;
+    uint32_t i;
+
+    (void) arg;
+    for (i = 0; i < ITEMS; i++) {
+        item.Seq = i;
+        item.Check = ~i;
+        pthread_mutex_lock(&lock);
+        Test_assert(Queue_write(&queue, &item) == Queue_Ok);
+        pthread_mutex_unlock(&lock);
+        if ((i & 15) == 0) {
+            Test_yield();
+        }
+    }
+    producerDone = 1;
+    return NULL;
+}
+
+static void testConcurrent(void) {
+    pthread_t thread;
+    Item item;
+    Item* ptr;
+    uint32_t mark;
+    uint32_t read = 0;
+    uint32_t retries = 0;
+    int64_t last = -1;
+    uint8_t done = 0;
+
+    Queue_initOverwrite(&queue, queueBuffer, sizeof(queueBuffer), sizeof(Item));
+    producerDone = 0;
+    Test_assert(pthread_create(&thread, NULL, producer, NULL) == 0);
+    while (!done) {
+        done = producerDone;
+        pthread_mutex_lock(&lock);
+        if (Queue_isEmpty(&queue)) {
+            pthread_mutex_unlock(&lock);
+            if (!done) {
+                Test_yield();
+            }
+            continue;
+        }
+        mark = Queue_overwriteMark(&queue);
+        ptr = (Item*) Queue_getReadPtr(&queue);
+        pthread_mutex_unlock(&lock);
+        // copy outside of lock, writer may overwrite it meanwhile
+        item = *ptr;
+        if (((read + retries) & 3) == 0) {
+            Test_yield();
+        }
+        pthread_mutex_lock(&lock);
+        if (Queue_wasOverwritten(&queue, mark)) {
+            retries++;
+        }
+        else {
+            Test_assert(Queue_moveReadPos(&queue, 1) == Queue_Ok);
+            Test_assert(item.Check == ~item.Seq);
+            Test_assert((int64_t) item.Seq > last);
+            last = item.Seq;
+            read++;
+        }
+        pthread_mutex_unlock(&lock);
+        done = done && Queue_isEmpty(&queue);
+    }
+    pthread_join(thread, NULL);
+    Test_assert(last == ITEMS - 1);
+    Test_assert(read > 0);
+    Test_assert(read + Queue_getDropped(&queue) == ITEMS);
+    printf("read %u, dropped %u, retries %u\n", read, Queue_getDropped(&queue), retries);
+}
+
+int main(void) {
+    Test_run(testDropOldest);
+    Test_run(testConcurrent);
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include "PriorityQueue.h"
+#include "QueueTest.h"
+
+#define LEVELS          3
+
+static PriorityQueue pq;
+static Queue levels[QUEUE_PRIORITY_MAX_LEVELS];
+static uint16_t levelBuffers[QUEUE_PRIORITY_MAX_LEVELS][16];
+
+static void initLevels(uint8_t count) {
+    uint8_t i;
+
+    for (i = 0; i < count; i++) {
+        Queue_init(&levels[i], levelBuffers[i], sizeof(levelBuffers[i]), sizeof(uint16_t));
+    }
+    PriorityQueue_init(&pq, levels, count);
+}
+
+static void writeLevel(uint8_t level, uint16_t count) {
+    uint16_t val;
+    uint16_t i;
+
+    for (i = 0; i < count; i++) {
+        // level in high byte, sequence in low byte
+        val = (uint16_t) ((level << 8) | i);
+        Test_assert(PriorityQueue_write(&pq, level, &val) == Queue_Ok);
+    }
+}
+
+static void testStrict(void) {
+    uint16_t val[8];
+    uint16_t i;
+
+    initLevels(LEVELS);
+    Test_assert(PriorityQueue_read(&pq, val) == Queue_NoAvailable);
+    writeLevel(2, 4);
+    writeLevel(0, 2);
+    writeLevel(1, 3);
+    Test_assert(PriorityQueue_available(&pq) == 9);
+    // highest level first, FIFO inside level, one call may span levels
+    Test_assert(PriorityQueue_readArray(&pq, val, 4) == 4);
+    Test_assert(val[0] == 0x0000 && val[1] == 0x0001 && val[2] == 0x0100 && val[3] == 0x0101);
+    writeLevel(0, 1);
+    Test_assert(PriorityQueue_read(&pq, val) == Queue_Ok && val[0] == 0x0000);
+    Test_assert(PriorityQueue_readArray(&pq, val, 8) == 5);
+    Test_assert(val[0] == 0x0102);
+    for (i = 0; i < 4; i++) {
+        Test_assert(val[1 + i] == (0x0200 | i));
+    }
+    Test_assert(PriorityQueue_isEmpty(&pq));
+    Test_assert(PriorityQueue_read(&pq, val) == Queue_NoAvailable);
+}
+
+static void testWeighted(void) {
+    const PriorityQueue_Weight weights[LEVELS] = { 3, 2, 1 };
+    uint16_t val;
+    uint8_t expected[] = { 0, 0, 0, 1, 1, 2, 0, 0, 0, 1, 1, 2, 0, 0, 1, 1, 2, 1, 2, 2, 2 };
+    uint8_t i;
+
+    initLevels(LEVELS);
+    PriorityQueue_setWeights(&pq, weights);
+    Test_assert(PriorityQueue_isFair(&pq));
+    writeLevel(0, 8);
+    writeLevel(1, 7);
+    writeLevel(2, 6);
+    // each round level n read at most weights[n] items, empty levels skipped
+    for (i = 0; i < sizeof(expected); i++) {
+        Test_assert(PriorityQueue_read(&pq, &val) == Queue_Ok);
+        Test_assert((val >> 8) == expected[i]);
+    }
+    Test_assert(PriorityQueue_isEmpty(&pq));
+    // back to strict order
+    PriorityQueue_setWeights(&pq, NULL);
+    writeLevel(1, 2);
+    writeLevel(0, 2);
+    Test_assert(PriorityQueue_read(&pq, &val) == Queue_Ok && (val >> 8) == 0);
+    Test_assert(PriorityQueue_read(&pq, &val) == Queue_Ok && (val >> 8) == 0);
+}
+
+static void testAllLevels(void) {
+    uint16_t val;
+    int level;
+
+    initLevels(QUEUE_PRIORITY_MAX_LEVELS);
+    PriorityQueue_setWeights(&pq, NULL);
+    for (level = QUEUE_PRIORITY_MAX_LEVELS - 1; level >= 0; level--) {
+        writeLevel((uint8_t) level, 1);
+    }
+    for (level = 0; level < QUEUE_PRIORITY_MAX_LEVELS; level++) {
+        Test_assert(PriorityQueue_read(&pq, &val) == Queue_Ok && (val >> 8) == level);
+    }
+    Test_assert(PriorityQueue_read(&pq, &val) == Queue_NoAvailable);
+}
+
+static void testInvalidLevel(void) {
+    uint16_t val = 0x55;
+
+    initLevels(LEVELS);
+    Test_assert(PriorityQueue_write(&pq, LEVELS, &val) == Queue_NoSpace);
+    Test_assert(PriorityQueue_write(&pq, 200, &val) == Queue_NoSpace);
+#if STREAM_WRITE_ARRAY
+    Test_assert(PriorityQueue_writeArray(&pq, LEVELS, &val, 1) == Queue_NoSpace);
+#endif
+    Test_assert(PriorityQueue_isEmpty(&pq));
+    Test_assert(PriorityQueue_read(&pq, &val) == Queue_NoAvailable);
+}
+
+int main(void) {
+    Test_run(testStrict);
+    Test_run(testWeighted);
+    Test_run(testAllLevels);
+    Test_run(testInvalidLevel);
+    return 0;
+}
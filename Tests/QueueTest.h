@@ -0,0 +1,42 @@
+/**
+ * @file QueueTest.h
+ * @author Ali Mirghasemi (ali.mirghasemi1376@gmail.com)
+ * @brief minimal assert and thread helpers shared by queue tests
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+#ifndef _QUEUE_TEST_H_
+#define _QUEUE_TEST_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+
+/**
+ * @brief check condition, print location and exit with failure if it's false
+ * it's not disabled by NDEBUG, so tests work in release builds too
+ */
+#define Test_assert(COND)               do { \
+                                            if (!(COND)) { \
+                                                printf("%s:%d: assert failed: %s\n", __FILE__, __LINE__, #COND); \
+                                                exit(1); \
+                                            } \
+                                        } while (0)
+/**
+ * @brief run a test function and print its name
+ */
+#define Test_run(FN)                    do { \
+                                            printf("%s\n", #FN); \
+                                            FN(); \
+                                        } while (0)
+/**
+ * @brief give other threads chance to run, tests may run on single core machines
+ */
+#define Test_yield()                    sched_yield()
+
+#endif /* _QUEUE_TEST_H_ */
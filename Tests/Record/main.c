@@ -0,0 +1,90 @@
+#include "Queue.h"
+#include "QueueTest.h"
+
+#include <string.h>
+
+static Queue queue;
+static uint32_t queueBuffer[16];
+
+static void testOutOfOrderCommit(void) {
+    Queue_LenType len;
+    char* a;
+    char* b;
+    char* ptr;
+
+    Queue_initRecord(&queue, queueBuffer, sizeof(queueBuffer));
+    a = (char*) Queue_reserve(&queue, 5);
+    b = (char*) Queue_reserve(&queue, 3);
+    Test_assert(a != NULL && b != NULL);
+    memcpy(a, "hello", 5);
+    memcpy(b, "abc", 3);
+    // second record is not visible until first one committed
+    Test_assert(Queue_commit(&queue, b) == Queue_Ok);
+    Test_assert(Queue_peekRecord(&queue, &len) == NULL);
+    Test_assert(Queue_commit(&queue, a) == Queue_Ok);
+    ptr = (char*) Queue_peekRecord(&queue, &len);
+    Test_assert(ptr != NULL && len == 5 && memcmp(ptr, "hello", 5) == 0);
+    Test_assert(Queue_release(&queue) == Queue_Ok);
+    ptr = (char*) Queue_peekRecord(&queue, &len);
+    Test_assert(ptr != NULL && len == 3 && memcmp(ptr, "abc", 3) == 0);
+    Test_assert(Queue_release(&queue) == Queue_Ok);
+    Test_assert(Queue_release(&queue) == Queue_NoAvailable);
+}
+
+static void writeRecord(uint8_t first) {
+    uint8_t* ptr = (uint8_t*) Queue_reserve(&queue, 17);
+    uint8_t i;
+
+    Test_assert(ptr != NULL);
+    for (i = 0; i < 17; i++) {
+        ptr[i] = (uint8_t) (first + i);
+    }
+    Test_assert(Queue_commit(&queue, ptr) == Queue_Ok);
+}
+
+static void testWrapPadding(void) {
+    Queue_LenType len;
+    uint8_t* ptr;
+    uint8_t next = 0;
+    int round;
+
+    Queue_initRecord(&queue, queueBuffer, sizeof(queueBuffer));
+    // 64-byte buffer, 20-byte records don't divide it, padding inserted at end
+    writeRecord(0);
+    for (round = 1; round < 50; round++) {
+        writeRecord((uint8_t) round);
+        ptr = (uint8_t*) Queue_peekRecord(&queue, &len);
+        Test_assert(ptr != NULL && len == 17);
+        Test_assert(ptr[0] == next && ptr[16] == (uint8_t) (next + 16));
+        Test_assert(Queue_release(&queue) == Queue_Ok);
+        next++;
+    }
+}
+
+static void testTooLarge(void) {
+    void* ptr;
+
+    Queue_initRecord(&queue, queueBuffer, sizeof(queueBuffer));
+    // record with header fill whole buffer
+    ptr = Queue_reserve(&queue, sizeof(queueBuffer) - QUEUE_RECORD_HEADER);
+    Test_assert(ptr != NULL);
+    Test_assert(Queue_commit(&queue, ptr) == Queue_Ok);
+    Test_assert(Queue_release(&queue) == Queue_Ok);
+    // rounded size of these lengths overflow or exceed buffer
+    Test_assert(Queue_reserve(&queue, sizeof(queueBuffer) - QUEUE_RECORD_HEADER + 1) == NULL);
+    Test_assert(Queue_reserve(&queue, (Queue_LenType) QUEUE_RECORD_MAX_LEN) == NULL);
+    Test_assert(Queue_reserve(&queue, (Queue_LenType) 0x7FFFFFFD) == NULL);
+    Test_assert(Queue_reserve(&queue, -1) == NULL);
+    // failed reserve doesn't change state
+    ptr = Queue_reserve(&queue, 8);
+    Test_assert(ptr != NULL);
+    Test_assert(Queue_commit(&queue, ptr) == Queue_Ok);
+    Test_assert(Queue_availableRaw(&queue) == QUEUE_RECORD_HEADER + 8);
+}
+
+int main(void) {
+    Test_run(testOutOfOrderCommit);
+    Test_run(testWrapPadding);
+    Test_run(testTooLarge);
+    return 0;
+}
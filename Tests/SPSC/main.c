@@ -0,0 +1,101 @@
+#include "Queue.h"
+#include "QueueTest.h"
+
+#define ITEMS           200000
+
+static QueueSPSC spsc;
+static uint32_t spscBuffer[64];
+
+static Queue_Result addIndex(QueueSPSC* queue, void* val, Queue_LenType index, Queue_LenType len) {
+    (void) queue;
+    (void) len;
+    *(uint32_t*) val = 100 + (uint32_t) index;
+    return Queue_Ok;
+}
+
+static void testBasic(void) {
+    uint32_t val[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint32_t out[8];
+    uint32_t i;
+
+    // size is rounded down to whole items
+    Test_assert(QueueSPSC_init(&spsc, spscBuffer, sizeof(spscBuffer), 0) == Queue_NoSpace);
+    Test_assert(QueueSPSC_init(&spsc, spscBuffer, sizeof(spscBuffer), -4) == Queue_NoSpace);
+    Test_assert(QueueSPSC_init(&spsc, spscBuffer, 3, sizeof(uint32_t)) == Queue_NoSpace);
+    Test_assert(QueueSPSC_init(&spsc, spscBuffer, sizeof(spscBuffer) - 1, sizeof(uint32_t)) == Queue_Ok);
+    Test_assert(QueueSPSC_getBufferSize(&spsc) == 63);
+    Test_assert(QueueSPSC_isEmpty(&spsc));
+    Test_assert(QueueSPSC_read(&spsc, out) == Queue_NoAvailable);
+    Test_assert(QueueSPSC_writeArray(&spsc, val, 0) == Queue_ZeroLen);
+    // fill and wrap around several times
+    for (i = 0; i < 100; i++) {
+        Test_assert(QueueSPSC_writeArray(&spsc, val, 8) == Queue_Ok);
+        Test_assert(QueueSPSC_available(&spsc) == 8);
+        Test_assert(QueueSPSC_readArray(&spsc, out, 8) == Queue_Ok);
+        Test_assert(out[0] == 1 && out[7] == 8);
+    }
+    for (i = 0; i < 63; i++) {
+        Test_assert(QueueSPSC_write(&spsc, &i) == Queue_Ok);
+    }
+    Test_assert(QueueSPSC_isFull(&spsc));
+    Test_assert(QueueSPSC_write(&spsc, &i) == Queue_NoSpace);
+    for (i = 0; i < 63; i++) {
+        Test_assert(QueueSPSC_read(&spsc, out) == Queue_Ok && out[0] == i);
+    }
+    // query APIs
+    Test_assert(QueueSPSC_writeQueryArray(&spsc, 4, addIndex) == Queue_Ok);
+    Test_assert(QueueSPSC_readArray(&spsc, out, 4) == Queue_Ok);
+    Test_assert(out[0] == 100 && out[3] == 103);
+    QueueSPSC_deinit(&spsc);
+}
+
+static void* producer(void* arg) {
+    uint32_t val[5];
+    uint32_t seq = 0;
+    Queue_LenType len;
+    Queue_LenType i;
+
+    (void) arg;
+    while (seq < ITEMS) {
+        len = 1 + seq % 5;
+        if ((uint32_t) len > ITEMS - seq) {
+            len = (Queue_LenType) (ITEMS - seq);
+        }
+        for (i = 0; i < len; i++) {
+            val[i] = seq + (uint32_t) i;
+        }
+        if (QueueSPSC_writeArray(&spsc, val, len) == Queue_Ok) {
+            seq += (uint32_t) len;
+        }
+        else {
+            Test_yield();
+        }
+    }
+    return NULL;
+}
+
+static void testStress(void) {
+    pthread_t thread;
+    uint32_t val;
+    uint32_t expected = 0;
+
+    Test_assert(QueueSPSC_init(&spsc, spscBuffer, sizeof(spscBuffer), sizeof(uint32_t)) == Queue_Ok);
+    Test_assert(pthread_create(&thread, NULL, producer, NULL) == 0);
+    while (expected < ITEMS) {
+        if (QueueSPSC_read(&spsc, &val) == Queue_Ok) {
+            Test_assert(val == expected);
+            expected++;
+        }
+        else {
+            Test_yield();
+        }
+    }
+    pthread_join(thread, NULL);
+    Test_assert(QueueSPSC_isEmpty(&spsc));
+}
+
+int main(void) {
+    Test_run(testBasic);
+    Test_run(testStress);
+    return 0;
+}
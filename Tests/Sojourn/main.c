@@ -0,0 +1,102 @@
+#include "Queue.h"
+#include "QueueTest.h"
+
+#define CODEL_ITEMS     64
+
+static Queue queue;
+static uint32_t queueBuffer[CODEL_ITEMS];
+static Queue_TimeType stamps[CODEL_ITEMS];
+static Queue_TimeType now;
+
+static Queue_TimeType fakeClock(void) {
+    return now;
+}
+
+static void testUnaligned(void) {
+    uint8_t buffer[10];
+    uint32_t val = 7;
+
+    // 10-byte buffer hold 2.5 items, items are not aligned to stamps after wrap around
+    Queue_init(&queue, buffer, sizeof(buffer), sizeof(uint32_t));
+    Test_assert(Queue_setSojourn(&queue, stamps, fakeClock) == Queue_CustomError);
+    Test_assert(queue.Stamps == NULL);
+    Test_assert(Queue_write(&queue, &val) == Queue_Ok);
+    Test_assert(Queue_headSojourn(&queue) == 0);
+    Test_assert(Queue_read(&queue, &val) == Queue_Ok && val == 7);
+
+    Queue_init(&queue, queueBuffer, 4 * sizeof(uint32_t), sizeof(uint32_t));
+    Test_assert(Queue_setSojourn(&queue, stamps, NULL) == Queue_CustomError);
+    Test_assert(Queue_setSojourn(&queue, stamps, fakeClock) == Queue_Ok);
+    Test_assert(Queue_setSojourn(&queue, NULL, NULL) == Queue_Ok);
+}
+
+static void testSojourn(void) {
+    uint32_t val[4] = {0};
+    uint32_t i;
+
+    now = 100;
+    Queue_init(&queue, queueBuffer, 4 * sizeof(uint32_t), sizeof(uint32_t));
+    Test_assert(Queue_setSojourn(&queue, stamps, fakeClock) == Queue_Ok);
+    // wrap around a few times, each item stamped at its write time
+    for (i = 0; i < 10; i++) {
+        Test_assert(Queue_write(&queue, &i) == Queue_Ok);
+        now += 3;
+        Test_assert(Queue_read(&queue, val) == Queue_Ok && val[0] == i);
+        Test_assert(Queue_getSojourn(&queue) == 3);
+    }
+    // array write stamp all items with same time
+    Test_assert(Queue_writeArray(&queue, val, 3) == Queue_Ok);
+    now += 5;
+    Test_assert(Queue_write(&queue, val) == Queue_Ok);
+    now += 5;
+    Test_assert(Queue_headSojourn(&queue) == 10);
+    // failed write must not restamp queued items
+    Test_assert(Queue_writeArray(&queue, val, 2) == Queue_NoSpace);
+    Test_assert(Queue_headSojourn(&queue) == 10);
+    Test_assert(Queue_readArray(&queue, val, 3) == Queue_Ok);
+    Test_assert(Queue_getSojourn(&queue) == 10);
+    Test_assert(Queue_read(&queue, val) == Queue_Ok);
+    Test_assert(Queue_getSojourn(&queue) == 5);
+    Test_assert(Queue_headSojourn(&queue) == 0);
+}
+
+static Queue_TimeType runOverload(uint8_t codel) {
+    Queue_TimeType maxSojourn = 0;
+    uint32_t val;
+    uint32_t tick;
+
+    now = 0;
+    Queue_init(&queue, queueBuffer, sizeof(queueBuffer), sizeof(uint32_t));
+    Test_assert(Queue_setSojourn(&queue, stamps, fakeClock) == Queue_Ok);
+    Queue_setCodel(&queue, codel ? 5 : 0, 20);
+    // one item arrive each tick, one item served each 2 ticks
+    for (tick = 0; tick < 2000; tick++) {
+        now = tick;
+        val = tick;
+        (void) Queue_write(&queue, &val);
+        if ((tick & 1) != 0 && Queue_read(&queue, &val) == Queue_Ok && tick >= 1000) {
+            if (Queue_getSojourn(&queue) > maxSojourn) {
+                maxSojourn = Queue_getSojourn(&queue);
+            }
+        }
+    }
+    return maxSojourn;
+}
+
+static void testCodel(void) {
+    Queue_TimeType withoutCodel = runOverload(0);
+    Queue_TimeType withCodel = runOverload(1);
+
+    printf("max sojourn without codel %u, with codel %u, dropped %u\n",
+           (unsigned) withoutCodel, (unsigned) withCodel, Queue_getCodelDropped(&queue));
+    Test_assert(withoutCodel >= CODEL_ITEMS);
+    Test_assert(Queue_getCodelDropped(&queue) > 0);
+    Test_assert(withCodel < withoutCodel / 2);
+}
+
+int main(void) {
+    Test_run(testUnaligned);
+    Test_run(testSojourn);
+    Test_run(testCodel);
+    return 0;
+}
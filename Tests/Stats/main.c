@@ -0,0 +1,65 @@
+#include "Queue.h"
+#include "QueueTest.h"
+
+static Queue queue;
+static uint32_t queueBuffer[16];
+
+static void testCounters(void) {
+    Queue_Stats stats;
+    uint32_t val[8] = {0};
+
+    Queue_init(&queue, queueBuffer, sizeof(queueBuffer), sizeof(uint32_t));
+    Test_assert(Queue_read(&queue, val) == Queue_NoAvailable);
+    Test_assert(Queue_writeArray(&queue, val, 5) == Queue_Ok);
+    Test_assert(Queue_write(&queue, val) == Queue_Ok);
+    Test_assert(Queue_readArray(&queue, val, 4) == Queue_Ok);
+    Test_assert(Queue_writeArray(&queue, val, 8) == Queue_Ok);
+    Test_assert(Queue_writeArray(&queue, val, 8) == Queue_NoSpace);
+    Queue_getStats(&queue, &stats);
+    Test_assert(stats.Written == 14);
+    Test_assert(stats.Read == 4);
+    Test_assert(stats.NoSpace == 1);
+    Test_assert(stats.NoAvailable == 1);
+    Test_assert(stats.WriteLimitHits == 0 && stats.ReadLimitHits == 0);
+    Test_assert(stats.HighWatermark == 10);
+    // after each successful operation: 5, 6, 2, 10 items in queue
+    Test_assert(stats.Histogram[0] == 0);
+    Test_assert(stats.Histogram[2] == 1);
+    Test_assert(stats.Histogram[3] == 2);
+    Test_assert(stats.Histogram[4] == 1);
+    // empty queue count in bucket 0
+    Test_assert(Queue_readArray(&queue, val, 8) == Queue_Ok);
+    Test_assert(Queue_readArray(&queue, val, 2) == Queue_Ok);
+    Queue_getStats(&queue, &stats);
+    Test_assert(stats.Histogram[0] == 1 && stats.Histogram[2] == 2);
+    Test_assert(stats.HighWatermark == 10);
+
+    Queue_resetStats(&queue);
+    Queue_getStats(&queue, &stats);
+    Test_assert(stats.Written == 0 && stats.Read == 0 && stats.HighWatermark == 0);
+    Test_assert(stats.Histogram[2] == 0);
+}
+
+static void testLimitHits(void) {
+    Queue_Stats stats;
+    uint32_t val[4] = {0};
+
+    Queue_init(&queue, queueBuffer, sizeof(queueBuffer), sizeof(uint32_t));
+    Queue_setWriteLimit(&queue, 2);
+    Test_assert(Queue_writeArray(&queue, val, 3) == Queue_NoSpace);
+    Test_assert(Queue_writeArray(&queue, val, 2) == Queue_Ok);
+    Queue_setWriteLimit(&queue, QUEUE_NO_LIMIT);
+    Queue_setReadLimit(&queue, 1);
+    Test_assert(Queue_readArray(&queue, val, 2) == Queue_NoAvailable);
+    Test_assert(Queue_read(&queue, val) == Queue_Ok);
+    Queue_getStats(&queue, &stats);
+    Test_assert(stats.NoSpace == 1 && stats.WriteLimitHits == 1);
+    Test_assert(stats.NoAvailable == 1 && stats.ReadLimitHits == 1);
+    Test_assert(stats.Written == 2 && stats.Read == 1);
+}
+
+int main(void) {
+    Test_run(testCounters);
+    Test_run(testLimitHits);
+    return 0;
+}
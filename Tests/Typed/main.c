@@ -0,0 +1,54 @@
+#include "QueueTyped.h"
+#include "QueueTest.h"
+
+typedef struct {
+    uint16_t    Id;
+    uint8_t     Kind;
+    uint32_t    Value;
+} Message;
+
+QUEUE_DECLARE(MsgQueue, Message, 8)
+
+static MsgQueue msgQueue;
+
+static void testTyped(void) {
+    Message msg[8];
+    Message out[8];
+    uint16_t i;
+    uint16_t j;
+
+    MsgQueue_init(&msgQueue);
+    Test_assert(MsgQueue_getBufferSize(&msgQueue) == 8);
+    Test_assert(MsgQueue_isEmpty(&msgQueue));
+    Test_assert(MsgQueue_read(&msgQueue, out) == Queue_NoAvailable);
+    for (i = 0; i < 8; i++) {
+        msg[i].Id = i;
+        msg[i].Kind = (uint8_t) (i * 3);
+        msg[i].Value = 1000u + i;
+    }
+    // wrap around with mixed single and array operations
+    for (j = 0; j < 20; j++) {
+        Test_assert(MsgQueue_writeArray(&msgQueue, msg, 5) == Queue_Ok);
+        Test_assert(MsgQueue_write(&msgQueue, &msg[7]) == Queue_Ok);
+        Test_assert(MsgQueue_available(&msgQueue) == 6);
+        Test_assert(MsgQueue_space(&msgQueue) == 2);
+        Test_assert(MsgQueue_getAt(&msgQueue, 5)->Id == 7);
+        Test_assert(MsgQueue_writeArray(&msgQueue, msg, 3) == Queue_NoSpace);
+        Test_assert(MsgQueue_read(&msgQueue, out) == Queue_Ok);
+        Test_assert(out[0].Id == 0 && out[0].Value == 1000);
+        Test_assert(MsgQueue_readArray(&msgQueue, out, 5) == Queue_Ok);
+        Test_assert(out[3].Id == 4 && out[3].Kind == 12 && out[4].Id == 7);
+        Test_assert(MsgQueue_isEmpty(&msgQueue));
+    }
+    // typed queue and generic APIs share same state
+    Test_assert(MsgQueue_write(&msgQueue, &msg[2]) == Queue_Ok);
+    Test_assert(Queue_available(MsgQueue_base(&msgQueue)) == 1);
+    Test_assert(Queue_read(MsgQueue_base(&msgQueue), out) == Queue_Ok);
+    Test_assert(out[0].Id == 2);
+    MsgQueue_deinit(&msgQueue);
+}
+
+int main(void) {
+    Test_run(testTyped);
+    return 0;
+}
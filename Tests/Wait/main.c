@@ -0,0 +1,112 @@
+#include "Queue.h"
+#include "QueueTest.h"
+
+#include <poll.h>
+#include <time.h>
+
+#define ITEMS           100000
+
+static Queue queue;
+static uint32_t queueBuffer[8];
+
+static uint32_t nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t) (ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static void testTimeout(void) {
+    uint32_t val = 0;
+    uint32_t start;
+
+    Queue_init(&queue, queueBuffer, sizeof(queueBuffer), sizeof(uint32_t));
+    Test_assert(Queue_readWait(&queue, &val, 0) == Queue_NoAvailable);
+    start = nowMs();
+    Test_assert(Queue_readWait(&queue, &val, 50) == Queue_NoAvailable);
+    Test_assert(nowMs() - start >= 40);
+    // full queue, write time out
+    Test_assert(Queue_writeArray(&queue, queueBuffer, 8) == Queue_Ok);
+    start = nowMs();
+    Test_assert(Queue_writeWait(&queue, &val, 50) == Queue_NoSpace);
+    Test_assert(nowMs() - start >= 40);
+    Test_assert(Queue_readWait(&queue, &val, 50) == Queue_Ok);
+}
+
+static void* producer(void* arg) {
+    uint32_t val[3];
+    uint32_t seq = 0;
+    uint32_t len;
+    uint32_t i;
+
+    (void) arg;
+    while (seq < ITEMS) {
+        len = 1 + seq % 3;
+        if (len > ITEMS - seq) {
+            len = ITEMS - seq;
+        }
+        for (i = 0; i < len; i++) {
+            val[i] = seq + i;
+        }
+        Test_assert(Queue_writeArrayWait(&queue, val, (Queue_LenType) len, QUEUE_WAIT_FOREVER) == Queue_Ok);
+        seq += len;
+    }
+    return NULL;
+}
+
+static void testBlocking(void) {
+    pthread_t thread;
+    uint32_t val[2];
+    uint32_t expected = 0;
+
+    Queue_init(&queue, queueBuffer, sizeof(queueBuffer), sizeof(uint32_t));
+    Test_assert(pthread_create(&thread, NULL, producer, NULL) == 0);
+    while (expected < ITEMS) {
+        if (ITEMS - expected >= 2) {
+            Test_assert(Queue_readArrayWait(&queue, val, 2, QUEUE_WAIT_FOREVER) == Queue_Ok);
+            Test_assert(val[0] == expected && val[1] == expected + 1);
+            expected += 2;
+        }
+        else {
+            Test_assert(Queue_readWait(&queue, val, QUEUE_WAIT_FOREVER) == Queue_Ok);
+            Test_assert(val[0] == expected);
+            expected++;
+        }
+    }
+    pthread_join(thread, NULL);
+    Test_assert(Queue_isEmpty(&queue));
+}
+
+static void* delayedWriter(void* arg) {
+    uint32_t val = 7;
+
+    (void) arg;
+    Test_yield();
+    Test_assert(Queue_write(&queue, &val) == Queue_Ok);
+    return NULL;
+}
+
+static void testEventFd(void) {
+    struct pollfd pfd;
+    pthread_t thread;
+    uint32_t val;
+
+    Queue_init(&queue, queueBuffer, sizeof(queueBuffer), sizeof(uint32_t));
+    pfd.fd = Queue_openEventFd(&queue);
+    pfd.events = POLLIN;
+    Test_assert(pfd.fd >= 0);
+    Test_assert(Queue_armEventFd(&queue) == 0);
+    Test_assert(poll(&pfd, 1, 0) == 0);
+    Test_assert(pthread_create(&thread, NULL, delayedWriter, NULL) == 0);
+    Test_assert(poll(&pfd, 1, 5000) == 1);
+    pthread_join(thread, NULL);
+    Test_assert(Queue_armEventFd(&queue) == 1);
+    Test_assert(Queue_read(&queue, &val) == Queue_Ok && val == 7);
+    Queue_deinit(&queue);
+}
+
+int main(void) {
+    Test_run(testTimeout);
+    Test_run(testBlocking);
+    Test_run(testEventFd);
+    return 0;
+}